@@ -114,6 +114,8 @@ PlasmaComponents3.Page {
                 if (expanded) {
                     handler.requestScan();
                     full.connectionModel = networkModelComponent.createObject(full)
+                    // Let the proxy model sort first, then prepare the rows the user is most likely to click
+                    Qt.callLater(function() { handler.prefetchActivations(appletProxyModel, 5) })
                 } else {
                     full.connectionModel.destroy()
                     toolbar.closeSearch();
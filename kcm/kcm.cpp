@@ -24,8 +24,8 @@
 #include "connectioneditordialog.h"
 #include "mobileconnectionwizard.h"
 #include "uiutils.h"
+#include "vpnimporter.h"
 #include "vpnuiplugin.h"
-#include "settings/wireguardinterfacewidget.h"
 
 // KDE
 #include <KMessageBox>
@@ -52,6 +52,7 @@
 // Qt
 #include <QFileDialog>
 #include <QMenu>
+#include <QProgressDialog>
 #include <QVBoxLayout>
 #include <QTimer>
 #include <QQmlContext>
@@ -66,6 +67,9 @@ KCMNetworkmanagement::KCMNetworkmanagement(QWidget *parent, const QVariantList &
     : KCModule(parent, args)
     , m_handler(new Handler(this))
     , m_tabWidget(nullptr)
+    , m_vpnImporter(nullptr)
+    , m_importProgress(nullptr)
+    , m_importedConnections(0)
     , m_ui(new Ui::KCMForm)
 {
     QWidget *mainWidget = new QWidget(this);
@@ -289,7 +293,15 @@ void KCMNetworkmanagement::onRequestCreateConnection(int connectionType, const Q
     NetworkManager::ConnectionSettings::ConnectionType type = static_cast<NetworkManager::ConnectionSettings::ConnectionType>(connectionType);
 
     if (type == NetworkManager::ConnectionSettings::Vpn && vpnType == "imported") {
-        importVpn();
+        const QStringList filenames = QFileDialog::getOpenFileNames(this, i18n("Import VPN Connection"), QDir::homePath(), VpnImporter::supportedFileExtensions());
+        if (!filenames.isEmpty()) {
+            importVpn(filenames);
+        }
+    } else if (type == NetworkManager::ConnectionSettings::Vpn && vpnType == "importedFolder") {
+        const QString directory = QFileDialog::getExistingDirectory(this, i18n("Import VPN Connections"), QDir::homePath());
+        if (!directory.isEmpty()) {
+            importVpn({directory});
+        }
     } else if (type == NetworkManager::ConnectionSettings::Gsm) { // launch the mobile broadband wizard, both gsm/cdma
 #if WITH_MODEMMANAGER_SUPPORT
         QPointer<MobileConnectionWizard> wizard = new MobileConnectionWizard(NetworkManager::ConnectionSettings::Unknown, this);
@@ -517,73 +529,69 @@ void KCMNetworkmanagement::loadConnectionSettings(const NetworkManager::Connecti
     kcmChanged(false);
 }
 
-void KCMNetworkmanagement::importVpn()
+void KCMNetworkmanagement::importVpn(const QStringList &paths)
 {
-    // get the list of supported extensions
-    const KService::List services = KServiceTypeTrader::self()->query("PlasmaNetworkManagement/VpnUiPlugin");
-    QString extensions;
-    for (const KService::Ptr &service : services) {
-        VpnUiPlugin * vpnPlugin = service->createInstance<VpnUiPlugin>(this);
-        if (vpnPlugin) {
-            extensions += vpnPlugin->supportedFileExtensions() % QStringLiteral(" ");
-            delete vpnPlugin;
-        }
-    }
-
-    const QString &filename = QFileDialog::getOpenFileName(this, i18n("Import VPN Connection"), QDir::homePath(), extensions.simplified());
-
-    if (!filename.isEmpty()) {
-        const KService::List services = KServiceTypeTrader::self()->query("PlasmaNetworkManagement/VpnUiPlugin");
-
-        QFileInfo fi(filename);
-        const QString ext = QStringLiteral("*.") % fi.suffix();
-        qCDebug(PLASMA_NM) << "Importing VPN connection " << filename << "extension:" << ext;
-
-        // Handle WireGuard separately because it is different than all the other VPNs
-        if (WireGuardInterfaceWidget::supportedFileExtensions().contains(ext)) {
-            NMVariantMapMap connection = WireGuardInterfaceWidget::importConnectionSettings(filename);
-            NetworkManager::ConnectionSettings connectionSettings;
-            connectionSettings.fromMap(connection);
-            connectionSettings.setUuid(NetworkManager::ConnectionSettings::createNewUuid());
-
-            // qCDebug(PLASMA_NM) << "Converted connection:" << connectionSettings;
-
-            m_handler->addConnection(connectionSettings.toMap());
-            // qCDebug(PLASMA_NM) << "Adding imported connection under id:" << conId;
-
-            if (!connection.isEmpty()) {
-                return; // get out if the import produced at least some output
+    if (!m_vpnImporter) {
+        m_vpnImporter = new VpnImporter(this);
+        connect(m_vpnImporter, &VpnImporter::progress, this, [this] (int done, int total) {
+            if (m_importProgress) {
+                m_importProgress->setMaximum(total);
+                m_importProgress->setValue(done);
             }
-        }
-        for (const KService::Ptr &service : services) {
-            VpnUiPlugin * vpnPlugin = service->createInstance<VpnUiPlugin>(this);
-            if (vpnPlugin && vpnPlugin->supportedFileExtensions().contains(ext)) {
-                qCDebug(PLASMA_NM) << "Found VPN plugin" << service->name() << ", type:" << service->property("X-NetworkManager-Services", QVariant::String).toString();
-
-                NMVariantMapMap connection = vpnPlugin->importConnectionSettings(filename);
-
-                // qCDebug(PLASMA_NM) << "Raw connection:" << connection;
-
-                NetworkManager::ConnectionSettings connectionSettings;
-                connectionSettings.fromMap(connection);
-                connectionSettings.setUuid(NetworkManager::ConnectionSettings::createNewUuid());
+        });
+        connect(m_vpnImporter, &VpnImporter::fileImported, this, [this] (const QString &fileName, const QString &connectionPath, const QStringList &warnings) {
+            qCDebug(PLASMA_NM) << "Imported VPN connection" << fileName << "as" << connectionPath;
+            ++m_importedConnections;
+            for (const QString &warning : warnings) {
+                m_importWarnings << QFileInfo(fileName).fileName() + QStringLiteral(": ") + warning;
+            }
+        });
+        connect(m_vpnImporter, &VpnImporter::fileFailed, this, [this] (const QString &fileName, const QString &error) {
+            qCWarning(PLASMA_NM) << "Failed to import VPN connection" << fileName << error;
+            m_importErrors << QFileInfo(fileName).fileName() + QStringLiteral(": ") + error;
+        });
+        connect(m_vpnImporter, &VpnImporter::finished, this, &KCMNetworkmanagement::importVpnFinished);
+    }
 
-                // qCDebug(PLASMA_NM) << "Converted connection:" << connectionSettings;
+    if (m_vpnImporter->isRunning()) {
+        return;
+    }
 
-                m_handler->addConnection(connectionSettings.toMap());
-                // qCDebug(PLASMA_NM) << "Adding imported connection under id:" << conId;
+    m_importErrors.clear();
+    m_importWarnings.clear();
+    m_importedConnections = 0;
+
+    m_importProgress = new QProgressDialog(i18n("Importing VPN connections..."), i18n("Cancel"), 0, 0, this);
+    m_importProgress->setWindowTitle(i18n("Import VPN Connections"));
+    m_importProgress->setWindowModality(Qt::WindowModal);
+    // Don't flash the dialog when importing a single file
+    m_importProgress->setMinimumDuration(500);
+    m_importProgress->setAutoClose(false);
+    m_importProgress->setAutoReset(false);
+    connect(m_importProgress, &QProgressDialog::canceled, m_vpnImporter, &VpnImporter::cancel);
+
+    qCDebug(PLASMA_NM) << "Importing VPN connections from" << paths;
+    m_vpnImporter->import(paths, this);
+}
 
-                if (connection.isEmpty()) { // the "positive" part will arrive with connectionAdded
-                    // TODO display success
-                } else {
-                    delete vpnPlugin;
-                    break; // stop iterating over the plugins if the import produced at least some output
-                }
+void KCMNetworkmanagement::importVpnFinished()
+{
+    if (m_importProgress) {
+        m_importProgress->deleteLater();
+        m_importProgress = nullptr;
+    }
 
-                delete vpnPlugin;
-            }
-        }
+    const QString summary = i18np("Imported %1 VPN connection.", "Imported %1 VPN connections.", m_importedConnections);
+    if (!m_importErrors.isEmpty()) {
+        KMessageBox::errorList(this, summary + QLatin1Char(' ') + i18np("%1 file could not be imported:", "%1 files could not be imported:", m_importErrors.size()),
+                               m_importErrors + m_importWarnings, i18n("Import VPN Connections"));
+    } else if (!m_importWarnings.isEmpty()) {
+        KMessageBox::informationList(this, summary + QLatin1Char(' ') + i18n("Some options could not be imported:"),
+                                     m_importWarnings, i18n("Import VPN Connections"));
     }
+
+    m_importErrors.clear();
+    m_importWarnings.clear();
 }
 
 void KCMNetworkmanagement::resetSelection()
@@ -27,7 +27,9 @@
 #include <KCModule>
 #include <ui_kcm.h>
 
+class QProgressDialog;
 class QQuickView;
+class VpnImporter;
 
 class KCMNetworkmanagement : public KCModule
 {
@@ -50,7 +52,8 @@ private Q_SLOTS:
 
 private:
     void addConnection(const NetworkManager::ConnectionSettings::Ptr &connectionSettings);
-    void importVpn();
+    void importVpn(const QStringList &paths);
+    void importVpnFinished();
     void kcmChanged(bool kcmChanged);
     void loadConnectionSettings(const NetworkManager::ConnectionSettings::Ptr &connectionSettings);
     void resetSelection();
@@ -60,6 +63,11 @@ private:
     Handler *m_handler;
     ConnectionEditorTabWidget *m_tabWidget;
     QTimer *m_timer;
+    VpnImporter *m_vpnImporter;
+    QProgressDialog *m_importProgress;
+    QStringList m_importErrors;
+    QStringList m_importWarnings;
+    int m_importedConnections;
     Ui::KCMForm *m_ui;
 };
 
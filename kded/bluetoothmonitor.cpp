@@ -22,6 +22,7 @@
 */
 
 #include "bluetoothmonitor.h"
+#include "connectionsindex.h"
 #include "debug.h"
 
 #include <KLocalizedString>
@@ -58,16 +59,7 @@ bool BluetoothMonitor::bluetoothConnectionExists(const QString &bdAddr, const QS
         return false;
     }
 
-    for (const NetworkManager::Connection::Ptr &con : NetworkManager::listConnections()) {
-        if (con && con->settings() && con->settings()->connectionType() == NetworkManager::ConnectionSettings::Bluetooth) {
-            NetworkManager::BluetoothSetting::Ptr btSetting = con->settings()->setting(NetworkManager::Setting::Bluetooth).staticCast<NetworkManager::BluetoothSetting>();
-            if (btSetting->profileType() == profile && btSetting->bluetoothAddress() == NetworkManager::macAddressFromString(bdAddr)) {
-                return true;
-            }
-        }
-    }
-
-    return false;
+    return !ConnectionsIndex::self()->bluetoothConnection(NetworkManager::macAddressFromString(bdAddr), profile).isNull();
 }
 
 void BluetoothMonitor::addBluetoothConnection(const QString &bdAddr, const QString &service, const QString &connectionName)
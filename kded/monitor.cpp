@@ -26,11 +26,6 @@
 Monitor::Monitor(QObject* parent)
     : QObject(parent)
 {
-#if WITH_MODEMMANAGER_SUPPORT
-    m_modemMonitor = new ModemMonitor(this);
-#endif
-    m_bluetoothMonitor = new BluetoothMonitor(this);
-
     QDBusConnection::sessionBus().registerService("org.kde.plasmanetworkmanagement");
     QDBusConnection::sessionBus().registerObject("/org/kde/plasmanetworkmanagement", this, QDBusConnection::ExportScriptableContents);
 }
@@ -43,13 +38,27 @@ Monitor::~Monitor()
 #endif
 }
 
+void Monitor::startMonitoring()
+{
+#if WITH_MODEMMANAGER_SUPPORT
+    if (!m_modemMonitor) {
+        m_modemMonitor = new ModemMonitor(this);
+    }
+#endif
+    if (!m_bluetoothMonitor) {
+        m_bluetoothMonitor = new BluetoothMonitor(this);
+    }
+}
+
 bool Monitor::bluetoothConnectionExists(const QString &bdAddr, const QString &service)
 {
+    startMonitoring();
     return m_bluetoothMonitor->bluetoothConnectionExists(bdAddr, service);
 }
 
 void Monitor::addBluetoothConnection(const QString &bdAddr, const QString &service, const QString &connectionName)
 {
+    startMonitoring();
     m_bluetoothMonitor->addBluetoothConnection(bdAddr, service, connectionName);
 }
 
@@ -57,6 +66,7 @@ void Monitor::addBluetoothConnection(const QString &bdAddr, const QString &servi
 void Monitor::unlockModem(const QString& modem)
 {
     qDebug() << "unlocking " << modem;
+    startMonitoring();
     m_modemMonitor->unlockModem(modem);
 }
 #endif
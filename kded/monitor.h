@@ -37,6 +37,9 @@ public:
     explicit Monitor(QObject * parent);
     ~Monitor() override;
 
+    // Creates the modem and Bluetooth monitors, the D-Bus interface is available before
+    void startMonitoring();
+
 public Q_SLOTS:
     Q_SCRIPTABLE bool bluetoothConnectionExists(const QString &bdAddr, const QString &service);
     Q_SCRIPTABLE void addBluetoothConnection(const QString &bdAddr, const QString &service, const QString &connectionName);
@@ -44,9 +47,9 @@ public Q_SLOTS:
     Q_SCRIPTABLE void unlockModem(const QString &modem);
 #endif
 private:
-    BluetoothMonitor * m_bluetoothMonitor;
+    BluetoothMonitor * m_bluetoothMonitor = nullptr;
 #if WITH_MODEMMANAGER_SUPPORT
-    ModemMonitor * m_modemMonitor;
+    ModemMonitor * m_modemMonitor = nullptr;
 #endif
 };
 
@@ -32,14 +32,24 @@
 #include <KNotification>
 
 #include <QDBusConnection>
+#include <QDateTime>
 #include <QIcon>
 #include <QTimer>
 
 #include <algorithm>
 
+// Notifications arriving within this interval are merged into one
+#define NOTIFICATION_COALESCE_INTERVAL 500
+// Minimal interval between two notifications for the same device or connection
+#define NOTIFICATION_RATE_LIMIT 5000
+
 Notification::Notification(QObject *parent) :
     QObject(parent)
 {
+    m_coalesceTimer = new QTimer(this);
+    m_coalesceTimer->setSingleShot(true);
+    connect(m_coalesceTimer, &QTimer::timeout, this, &Notification::flushNotifications);
+
     // devices
     for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
         addDevice(device);
@@ -78,9 +88,13 @@ void Notification::stateChanged(NetworkManager::Device::State newstate, NetworkM
     Q_UNUSED(oldstate)
 
     NetworkManager::Device *device = qobject_cast<NetworkManager::Device*>(sender());
-    if (newstate == NetworkManager::Device::Activated && m_notifications.contains(device->uni())) {
-        KNotification *notify = m_notifications.value(device->uni());
-        notify->close();
+    if (newstate == NetworkManager::Device::Activated) {
+        dropNotification(device->uni());
+        if (m_notifications.contains(device->uni())) {
+            KNotification *notify = m_notifications.value(device->uni());
+            notify->close();
+        }
+        removeFromGroupedNotification(device->uni());
         return;
     } else if (newstate != NetworkManager::Device::Failed) {
         return;
@@ -328,21 +342,7 @@ void Notification::stateChanged(NetworkManager::Device::State newstate, NetworkM
         return;
     }
 
-    if (m_notifications.contains(device->uni())) {
-        KNotification *notify = m_notifications.value(device->uni());
-        notify->setText(text.toHtmlEscaped());
-        notify->update();
-    } else {
-        KNotification *notify = new KNotification(QStringLiteral("DeviceFailed"), KNotification::CloseOnTimeout);
-        connect(notify, &KNotification::closed, this, &Notification::notificationClosed);
-        notify->setProperty("uni", device->uni());
-        notify->setComponentName(QStringLiteral("networkmanagement"));
-        notify->setIconName(QStringLiteral("dialog-warning"));
-        notify->setTitle(identifier);
-        notify->setText(text.toHtmlEscaped());
-        m_notifications[device->uni()] = notify;
-        notify->sendEvent();
-    }
+    queueNotification(device->uni(), {QStringLiteral("DeviceFailed"), identifier, text, QStringLiteral("dialog-warning")});
 }
 
 void Notification::addActiveConnection(const QString &path)
@@ -434,28 +434,15 @@ void Notification::onActiveConnectionStateChanged(NetworkManager::ActiveConnecti
         return;
     }
 
-    KNotification *notify = m_notifications.value(connectionId);
-
-    if (!notify) {
-        notify = new KNotification(eventId, KNotification::CloseOnTimeout);
-        connect(notify, &KNotification::closed, this, &Notification::notificationClosed);
-        notify->setProperty("uni", connectionId);
-        notify->setComponentName(QStringLiteral("networkmanagement"));
-        m_notifications[connectionId] = notify;
-    }
-
-    if (!iconName.isEmpty()) {
-        notify->setIconName(iconName);
-    } else {
+    if (iconName.isEmpty()) {
         if (state == NetworkManager::ActiveConnection::Activated) {
-            notify->setIconName(QStringLiteral("dialog-information"));
+            iconName = QStringLiteral("dialog-information");
         } else {
-            notify->setIconName(QStringLiteral("dialog-warning"));
+            iconName = QStringLiteral("dialog-warning");
         }
     }
-    notify->setTitle(acName);
-    notify->setText(text.toHtmlEscaped());
-    notify->sendEvent();
+
+    queueNotification(connectionId, {eventId, acName, text, iconName});
 }
 
 void Notification::onVpnConnectionStateChanged(NetworkManager::VpnConnection::State state, NetworkManager::VpnConnection::StateChangeReason reason)
@@ -517,25 +504,18 @@ void Notification::onVpnConnectionStateChanged(NetworkManager::VpnConnection::St
         break;
     }
 
-    KNotification *notify = new KNotification(eventId, KNotification::CloseOnTimeout);
-    connect(notify, &KNotification::closed, this, &Notification::notificationClosed);
-    notify->setProperty("uni", connectionId);
-    notify->setComponentName("networkmanagement");
-    if (state == NetworkManager::VpnConnection::Activated) {
-        notify->setIconName(QStringLiteral("dialog-information"));
-    } else {
-        notify->setIconName(QStringLiteral("dialog-warning"));
-    }
-    notify->setTitle(vpnName);
-    notify->setText(text.toHtmlEscaped());
-    m_notifications[connectionId] = notify;
-    notify->sendEvent();
+    const QString iconName = state == NetworkManager::VpnConnection::Activated ? QStringLiteral("dialog-information") : QStringLiteral("dialog-warning");
+    queueNotification(connectionId, {eventId, vpnName, text, iconName});
 }
 
 void Notification::notificationClosed()
 {
     KNotification *notify = qobject_cast<KNotification*>(sender());
-    m_notifications.remove(notify->property("uni").toString());
+    const QString uni = notify->property("uni").toString();
+    m_notifications.remove(uni);
+    if (uni == QLatin1String("groupedNotification")) {
+        m_groupedNotifications.clear();
+    }
 }
 
 void Notification::onPrepareForSleep(bool sleep)
@@ -586,14 +566,147 @@ void Notification::onCheckActiveConnectionOnResume()
         return;
     }
 
-    KNotification *notify = new KNotification(QStringLiteral("NoLongerConnected"), KNotification::CloseOnTimeout);
-    connect(notify, &KNotification::closed, this, &Notification::notificationClosed);
-    const QString uni = QStringLiteral("offlineNotification");
-    notify->setProperty("uni", uni);
-    notify->setComponentName("networkmanagement");
-    notify->setIconName(QStringLiteral("dialog-warning"));
-    notify->setTitle(i18n("No Network Connection"));
-    notify->setText(i18n("You are no longer connected to a network."));
-    m_notifications[uni] = notify;
-    notify->sendEvent();
+    queueNotification(QStringLiteral("offlineNotification"), {QStringLiteral("NoLongerConnected"), i18n("No Network Connection"),
+                                                              i18n("You are no longer connected to a network."), QStringLiteral("dialog-warning")});
+}
+
+void Notification::queueNotification(const QString &uni, const PendingNotification &notification)
+{
+    if (m_pendingNotifications.contains(uni)) {
+        // Only the latest state of a device or connection is worth showing
+        ++m_suppressedNotifications;
+        qCDebug(PLASMA_NM) << "Replacing queued notification for" << uni << "suppressed so far:" << m_suppressedNotifications;
+    } else {
+        m_pendingOrder << uni;
+    }
+    m_pendingNotifications.insert(uni, notification);
+
+    // The timer may be waiting for a rate limited notification, don't let this one wait for it
+    if (!m_coalesceTimer->isActive() || m_coalesceTimer->remainingTime() > NOTIFICATION_COALESCE_INTERVAL) {
+        m_coalesceTimer->start(NOTIFICATION_COALESCE_INTERVAL);
+    }
+}
+
+void Notification::dropNotification(const QString &uni)
+{
+    if (m_pendingNotifications.remove(uni)) {
+        m_pendingOrder.removeOne(uni);
+        ++m_suppressedNotifications;
+    }
+}
+
+void Notification::flushNotifications()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    // Forget rate limits which already expired
+    auto it = m_lastNotified.begin();
+    while (it != m_lastNotified.end()) {
+        if (it.value() + NOTIFICATION_RATE_LIMIT <= now) {
+            it = m_lastNotified.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    QStringList ready;
+    QStringList delayed;
+    qint64 nextFlush = 0;
+    for (const QString &uni : qAsConst(m_pendingOrder)) {
+        const qint64 allowedAt = m_lastNotified.value(uni) + NOTIFICATION_RATE_LIMIT;
+        if (m_lastNotified.contains(uni) && allowedAt > now) {
+            delayed << uni;
+            nextFlush = nextFlush ? qMin(nextFlush, allowedAt) : allowedAt;
+        } else {
+            ready << uni;
+            m_lastNotified.insert(uni, now);
+        }
+    }
+    m_pendingOrder = delayed;
+
+    if (ready.size() == 1) {
+        showNotification(ready.first(), m_pendingNotifications.take(ready.first()));
+    } else if (ready.size() > 1) {
+        m_groupedNotifications.clear();
+        for (const QString &uni : qAsConst(ready)) {
+            m_groupedNotifications << qMakePair(uni, m_pendingNotifications.take(uni));
+        }
+        showGroupedNotification();
+    }
+
+    if (!delayed.isEmpty()) {
+        m_coalesceTimer->start(qMax<qint64>(nextFlush - now, NOTIFICATION_COALESCE_INTERVAL));
+    }
+}
+
+void Notification::showNotification(const QString &uni, const PendingNotification &notification)
+{
+    // The grouped notification must not keep showing an older state of this device or connection
+    removeFromGroupedNotification(uni);
+
+    KNotification *notify = m_notifications.value(uni);
+    const bool updateOnly = notify != nullptr;
+
+    if (!notify) {
+        notify = new KNotification(notification.eventId, KNotification::CloseOnTimeout);
+        connect(notify, &KNotification::closed, this, &Notification::notificationClosed);
+        notify->setProperty("uni", uni);
+        notify->setComponentName(QStringLiteral("networkmanagement"));
+        m_notifications[uni] = notify;
+    }
+
+    notify->setIconName(notification.iconName);
+    notify->setTitle(notification.title);
+    notify->setText(notification.text.toHtmlEscaped());
+
+    if (updateOnly) {
+        notify->update();
+    } else {
+        notify->sendEvent();
+    }
+}
+
+void Notification::showGroupedNotification()
+{
+    // Use the event and icon of the last warning, if there is any, so failures are not hidden behind successes
+    PendingNotification grouped = m_groupedNotifications.last().second;
+    QStringList lines;
+    for (const auto &entry : qAsConst(m_groupedNotifications)) {
+        const PendingNotification &notification = entry.second;
+        lines << notification.title + QLatin1String(": ") + notification.text;
+        if (notification.iconName == QLatin1String("dialog-warning")) {
+            grouped.eventId = notification.eventId;
+            grouped.iconName = notification.iconName;
+        }
+    }
+
+    grouped.title = i18np("%1 network event", "%1 network events", m_groupedNotifications.size());
+    grouped.text = lines.join(QLatin1Char('\n'));
+    showNotification(QStringLiteral("groupedNotification"), grouped);
+}
+
+void Notification::removeFromGroupedNotification(const QString &uni)
+{
+    auto it = std::find_if(m_groupedNotifications.begin(), m_groupedNotifications.end(), [&uni] (const QPair<QString, PendingNotification> &entry) {
+        return entry.first == uni;
+    });
+    if (it == m_groupedNotifications.end()) {
+        return;
+    }
+    m_groupedNotifications.erase(it);
+
+    KNotification *notify = m_notifications.value(QStringLiteral("groupedNotification"));
+    const bool failures = std::any_of(m_groupedNotifications.constBegin(), m_groupedNotifications.constEnd(), [] (const QPair<QString, PendingNotification> &entry) {
+        return entry.second.iconName == QLatin1String("dialog-warning");
+    });
+
+    if (!notify || !failures) {
+        m_groupedNotifications.clear();
+        if (notify) {
+            notify->close();
+        }
+        return;
+    }
+
+    showGroupedNotification();
 }
@@ -53,8 +53,40 @@ private Q_SLOTS:
     void onPrepareForSleep(bool sleep);
     void onCheckActiveConnectionOnResume();
 
+    void flushNotifications();
+
 private:
+    struct PendingNotification {
+        QString eventId;
+        QString title;
+        QString text;
+        QString iconName;
+    };
+
+    /**
+     * Queues a notification for @uni, notifications queued within a short window are
+     * shown together and a newer one for the same @uni replaces the queued one
+     */
+    void queueNotification(const QString &uni, const PendingNotification &notification);
+    void dropNotification(const QString &uni);
+    void showNotification(const QString &uni, const PendingNotification &notification);
+    void showGroupedNotification();
+    /**
+     * Removes @uni from the grouped notification once its state is not worth reporting
+     * anymore, the notification is closed when no failure is left in it
+     */
+    void removeFromGroupedNotification(const QString &uni);
+
     QHash<QString, KNotification*> m_notifications;
+    // Devices and connections listed in the grouped notification
+    QList<QPair<QString, PendingNotification>> m_groupedNotifications;
+
+    QHash<QString, PendingNotification> m_pendingNotifications;
+    QStringList m_pendingOrder;
+    // When the last notification for given uni was shown, used for rate limiting
+    QHash<QString, qint64> m_lastNotified;
+    QTimer *m_coalesceTimer = nullptr;
+    quint64 m_suppressedNotifications = 0;
 
     bool m_preparingForSleep = false;
     QStringList m_activeConnectionsBeforeSleep;
@@ -21,21 +21,43 @@
 
 #include "portalmonitor.h"
 
+#include "debug.h"
+
 #include <QDBusPendingCallWatcher>
 #include <QDBusPendingReply>
 #include <QDesktopServices>
+#include <QTimer>
 
 #include <KLocalizedString>
 #include <KNotification>
 
 #include <NetworkManagerQt/ActiveConnection>
+#include <NetworkManagerQt/WirelessDevice>
+
+// Re-checks after a portal was detected start at this interval and double
+// up to the maximum, which is also what NetworkManager uses by default
+#define PORTAL_CHECK_MIN_INTERVAL 5000
+#define PORTAL_CHECK_MAX_INTERVAL 300000
+// Number of networks to remember
+#define PORTAL_STATES_MAX 64
 
 PortalMonitor::PortalMonitor(QObject *parent)
     : QObject(parent)
+    , m_checkInterval(PORTAL_CHECK_MIN_INTERVAL)
 {
-    checkConnectivity();
+    m_checkTimer = new QTimer(this);
+    m_checkTimer->setSingleShot(true);
+    connect(m_checkTimer, &QTimer::timeout, this, &PortalMonitor::checkConnectivity);
+
+    m_currentNetwork = currentNetwork();
+
+    // Use the state NM already knows about instead of triggering a new check on startup
+    if (NetworkManager::connectivity() == NetworkManager::Portal) {
+        connectivityChanged(NetworkManager::Portal);
+    }
 
     connect(NetworkManager::notifier(), &NetworkManager::Notifier::connectivityChanged, this, &PortalMonitor::connectivityChanged);
+    connect(NetworkManager::notifier(), &NetworkManager::Notifier::primaryConnectionChanged, this, &PortalMonitor::primaryConnectionChanged);
 }
 
 PortalMonitor::~PortalMonitor()
@@ -47,6 +69,12 @@ PortalMonitor::~PortalMonitor()
 
 void PortalMonitor::connectivityChanged(NetworkManager::Connectivity connectivity)
 {
+    // None, Limited and Unknown are seen while disconnecting or roaming, they don't
+    // tell whether the portal is gone
+    if (connectivity == NetworkManager::Portal || connectivity == NetworkManager::Full) {
+        updatePortalState(connectivity == NetworkManager::Portal);
+    }
+
     if (connectivity == NetworkManager::Portal) {
         bool updateOnly = true;
         NetworkManager::ActiveConnection::Ptr primaryConnection = NetworkManager::primaryConnection();
@@ -94,3 +122,90 @@ void PortalMonitor::checkConnectivity()
         watcher->deleteLater();
     });
 }
+
+void PortalMonitor::primaryConnectionChanged(const QString &uni)
+{
+    Q_UNUSED(uni)
+
+    m_currentNetwork = currentNetwork();
+    m_checkTimer->stop();
+    m_checkInterval = PORTAL_CHECK_MIN_INTERVAL;
+
+    // We have seen a portal on this network and it was not cleared since, don't wait
+    // for the next periodic check from NetworkManager to find out it's still there
+    const PortalState state = m_portalStates.value(m_currentNetwork);
+    if (state.portal) {
+        qCDebug(PLASMA_NM) << "Known captive portal on" << m_currentNetwork << "checking connectivity";
+        checkConnectivity();
+    }
+}
+
+QString PortalMonitor::currentNetwork() const
+{
+    NetworkManager::ActiveConnection::Ptr primaryConnection = NetworkManager::primaryConnection();
+    if (!primaryConnection) {
+        return QString();
+    }
+
+    QString network = primaryConnection->uuid();
+
+    const QStringList devices = primaryConnection->devices();
+    if (!devices.isEmpty()) {
+        NetworkManager::WirelessDevice::Ptr wirelessDevice = NetworkManager::findNetworkInterface(devices.first()).objectCast<NetworkManager::WirelessDevice>();
+        if (wirelessDevice && wirelessDevice->activeAccessPoint()) {
+            network += QLatin1Char('/') + wirelessDevice->activeAccessPoint()->hardwareAddress();
+        }
+    }
+
+    return network;
+}
+
+void PortalMonitor::updatePortalState(bool portal)
+{
+    if (m_currentNetwork.isEmpty()) {
+        m_currentNetwork = currentNetwork();
+        if (m_currentNetwork.isEmpty()) {
+            return;
+        }
+    }
+
+    if (portal) {
+        if (!m_portalStates.contains(m_currentNetwork) && m_portalStates.size() >= PORTAL_STATES_MAX) {
+            // Forget the network we heard of the longest time ago
+            auto oldest = m_portalStates.begin();
+            for (auto it = m_portalStates.begin(); it != m_portalStates.end(); ++it) {
+                if (qMax(it->lastSeen, it->lastCleared) < qMax(oldest->lastSeen, oldest->lastCleared)) {
+                    oldest = it;
+                }
+            }
+            m_portalStates.erase(oldest);
+        }
+
+        PortalState &state = m_portalStates[m_currentNetwork];
+        state.portal = true;
+        state.lastSeen = QDateTime::currentDateTime();
+        scheduleCheck();
+    } else {
+        // Only networks where a portal was seen are worth remembering
+        auto it = m_portalStates.find(m_currentNetwork);
+        if (it != m_portalStates.end() && it->portal) {
+            it->portal = false;
+            it->lastCleared = QDateTime::currentDateTime();
+            qCDebug(PLASMA_NM) << "Captive portal on" << m_currentNetwork << "cleared";
+        }
+
+        m_checkTimer->stop();
+        m_checkInterval = PORTAL_CHECK_MIN_INTERVAL;
+    }
+}
+
+void PortalMonitor::scheduleCheck()
+{
+    if (m_checkTimer->isActive()) {
+        return;
+    }
+
+    qCDebug(PLASMA_NM) << "Captive portal on" << m_currentNetwork << "checking again in" << m_checkInterval << "ms";
+    m_checkTimer->start(m_checkInterval);
+    m_checkInterval = qMin(m_checkInterval * 2, PORTAL_CHECK_MAX_INTERVAL);
+}
@@ -25,9 +25,13 @@
 #include <NetworkManagerQt/Manager>
 
 #include <KNotification>
+#include <QDateTime>
+#include <QHash>
 #include <QObject>
 #include <QPointer>
 
+class QTimer;
+
 class PortalMonitor : public QObject
 {
     Q_OBJECT
@@ -38,9 +42,29 @@ public:
 private Q_SLOTS:
     void connectivityChanged(NetworkManager::Connectivity connectivity);
     void checkConnectivity();
+    void primaryConnectionChanged(const QString &uni);
 
 private:
+    // What we know about a portal on given network
+    struct PortalState {
+        bool portal = false;
+        QDateTime lastSeen;
+        QDateTime lastCleared;
+    };
+
+    /**
+     * Returns key of the current network, uuid of the primary connection
+     * followed by BSSID of the access point for wireless networks
+     */
+    QString currentNetwork() const;
+    void updatePortalState(bool portal);
+    void scheduleCheck();
+
     QPointer<KNotification> m_notification;
+    QHash<QString, PortalState> m_portalStates;
+    QString m_currentNetwork;
+    QTimer *m_checkTimer = nullptr;
+    int m_checkInterval;
 };
 
 #endif // PLASMA_NM_PORTAL_MONITOR_H
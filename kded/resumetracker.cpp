@@ -0,0 +1,310 @@
+/*
+    Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "resumetracker.h"
+
+#include "debug.h"
+
+#include <KConfig>
+#include <KConfigGroup>
+
+#include <QDBusConnection>
+#include <QStandardPaths>
+#include <QTimer>
+
+#include <algorithm>
+
+// Give up waiting for connections which don't come back after resume
+#define RESUME_TIMEOUT 120000
+
+// Upper bounds of the histogram buckets in ms, the last bucket holds everything slower
+static const QVector<int> s_bucketBounds = { 250, 500, 1000, 2000, 5000, 10000, 20000, 30000, 60000 };
+
+static const QString s_connectivityKey = QStringLiteral("connectivity");
+
+ResumeTracker::ResumeTracker(QObject *parent)
+    : QObject(parent)
+{
+    m_resumeTimeout = new QTimer(this);
+    m_resumeTimeout->setInterval(RESUME_TIMEOUT);
+    m_resumeTimeout->setSingleShot(true);
+    connect(m_resumeTimeout, &QTimer::timeout, this, &ResumeTracker::finishResume);
+
+    load();
+
+    for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
+        watchDevice(device);
+    }
+    connect(NetworkManager::notifier(), &NetworkManager::Notifier::deviceAdded, this, &ResumeTracker::addDevice);
+
+    for (const NetworkManager::ActiveConnection::Ptr &ac : NetworkManager::activeConnections()) {
+        watchActiveConnection(ac);
+    }
+    connect(NetworkManager::notifier(), &NetworkManager::Notifier::activeConnectionAdded, this, &ResumeTracker::addActiveConnection);
+
+    connect(NetworkManager::notifier(), &NetworkManager::Notifier::connectivityChanged, this, &ResumeTracker::onConnectivityChanged);
+
+    QDBusConnection::systemBus().connect(QStringLiteral("org.freedesktop.login1"),
+                                         QStringLiteral("/org/freedesktop/login1"),
+                                         QStringLiteral("org.freedesktop.login1.Manager"),
+                                         QStringLiteral("PrepareForSleep"),
+                                         this,
+                                         SLOT(onPrepareForSleep(bool)));
+}
+
+ResumeTracker::~ResumeTracker()
+{
+}
+
+QVariantMap ResumeTracker::statistics() const
+{
+    QVariantList bounds;
+    for (int bound : s_bucketBounds) {
+        bounds << bound;
+    }
+
+    QVariantMap result;
+    for (auto it = m_histograms.constBegin(); it != m_histograms.constEnd(); ++it) {
+        const Histogram &histogram = it.value();
+
+        QVariantList buckets;
+        for (int count : histogram.buckets) {
+            buckets << count;
+        }
+
+        QVariantMap map;
+        map.insert(QStringLiteral("name"), histogram.name);
+        map.insert(QStringLiteral("count"), histogram.count);
+        map.insert(QStringLiteral("average"), histogram.count ? histogram.total / histogram.count : 0);
+        map.insert(QStringLiteral("max"), histogram.max);
+        map.insert(QStringLiteral("buckets"), buckets);
+        map.insert(QStringLiteral("bucketBounds"), bounds);
+        result.insert(it.key(), map);
+    }
+
+    result.insert(QStringLiteral("lastResume"), m_resuming ? m_timeline : m_lastTimeline);
+
+    return result;
+}
+
+void ResumeTracker::reset()
+{
+    m_histograms.clear();
+    m_lastTimeline.clear();
+    save();
+}
+
+void ResumeTracker::onPrepareForSleep(bool sleep)
+{
+    if (sleep) {
+        if (m_resuming) {
+            finishResume();
+        }
+
+        m_activeBeforeSleep.clear();
+        for (const NetworkManager::ActiveConnection::Ptr &ac : NetworkManager::activeConnections()) {
+            if (ac->state() == NetworkManager::ActiveConnection::Activated) {
+                m_activeBeforeSleep << ac->uuid();
+            }
+        }
+        return;
+    }
+
+    m_resuming = true;
+    m_resumeTimer.start();
+    m_pendingConnections = m_activeBeforeSleep;
+    m_connectivityRecorded = false;
+    m_timeline.clear();
+    recordEvent(QStringLiteral("resume"));
+    m_resumeTimeout->start();
+}
+
+void ResumeTracker::addActiveConnection(const QString &path)
+{
+    NetworkManager::ActiveConnection::Ptr ac = NetworkManager::findActiveConnection(path);
+    if (ac && ac->isValid()) {
+        watchActiveConnection(ac);
+    }
+}
+
+void ResumeTracker::addDevice(const QString &uni)
+{
+    NetworkManager::Device::Ptr device = NetworkManager::findNetworkInterface(uni);
+    if (device) {
+        watchDevice(device);
+    }
+}
+
+void ResumeTracker::watchActiveConnection(const NetworkManager::ActiveConnection::Ptr &ac)
+{
+    connect(ac.data(), &NetworkManager::ActiveConnection::stateChanged, this, &ResumeTracker::onActiveConnectionStateChanged);
+}
+
+void ResumeTracker::watchDevice(const NetworkManager::Device::Ptr &device)
+{
+    connect(device.data(), &NetworkManager::Device::stateChanged, this, &ResumeTracker::onDeviceStateChanged);
+}
+
+void ResumeTracker::onActiveConnectionStateChanged(NetworkManager::ActiveConnection::State state)
+{
+    if (!m_resuming) {
+        return;
+    }
+
+    NetworkManager::ActiveConnection *ac = qobject_cast<NetworkManager::ActiveConnection*>(sender());
+    if (!ac) {
+        return;
+    }
+
+    recordEvent(ac->id() + QLatin1Char(' ') + QString::number(state));
+
+    if (state == NetworkManager::ActiveConnection::Activated) {
+        // Only connections which were up before sleep, and only their first activation
+        if (m_pendingConnections.remove(ac->uuid())) {
+            recordLatency(ac->uuid(), ac->id(), m_resumeTimer.elapsed());
+        }
+
+        if (m_pendingConnections.isEmpty() && m_connectivityRecorded) {
+            finishResume();
+        }
+    }
+}
+
+void ResumeTracker::onDeviceStateChanged(NetworkManager::Device::State newstate, NetworkManager::Device::State oldstate, NetworkManager::Device::StateChangeReason reason)
+{
+    Q_UNUSED(oldstate)
+
+    if (!m_resuming) {
+        return;
+    }
+
+    NetworkManager::Device *device = qobject_cast<NetworkManager::Device*>(sender());
+    if (device) {
+        recordEvent(device->interfaceName() + QLatin1Char(' ') + QString::number(newstate) + QLatin1Char('/') + QString::number(reason));
+    }
+}
+
+void ResumeTracker::onConnectivityChanged(NetworkManager::Connectivity connectivity)
+{
+    if (!m_resuming) {
+        return;
+    }
+
+    recordEvent(QStringLiteral("connectivity ") + QString::number(connectivity));
+
+    if (connectivity == NetworkManager::Full && !m_connectivityRecorded) {
+        m_connectivityRecorded = true;
+        recordLatency(s_connectivityKey, QString(), m_resumeTimer.elapsed());
+
+        if (m_pendingConnections.isEmpty()) {
+            finishResume();
+        }
+    }
+}
+
+void ResumeTracker::finishResume()
+{
+    if (!m_resuming) {
+        return;
+    }
+
+    m_resuming = false;
+    m_resumeTimeout->stop();
+
+    if (!m_pendingConnections.isEmpty()) {
+        recordEvent(QStringLiteral("not reconnected: ") + QStringList(m_pendingConnections.values()).join(QLatin1String(", ")));
+    }
+    m_pendingConnections.clear();
+    m_lastTimeline = m_timeline;
+    m_timeline.clear();
+
+    save();
+}
+
+void ResumeTracker::recordEvent(const QString &event)
+{
+    const QString entry = QStringLiteral("+%1ms %2").arg(m_resumeTimer.elapsed()).arg(event);
+    qCDebug(PLASMA_NM) << "Resume:" << entry;
+    m_timeline << entry;
+}
+
+void ResumeTracker::recordLatency(const QString &key, const QString &name, qint64 latency)
+{
+    Histogram &histogram = m_histograms[key];
+    if (histogram.buckets.size() != s_bucketBounds.size() + 1) {
+        histogram.buckets.resize(s_bucketBounds.size() + 1);
+    }
+
+    const int bucket = std::upper_bound(s_bucketBounds.constBegin(), s_bucketBounds.constEnd(), latency) - s_bucketBounds.constBegin();
+    ++histogram.buckets[bucket];
+    ++histogram.count;
+    histogram.total += latency;
+    histogram.max = qMax(histogram.max, latency);
+    if (!name.isEmpty()) {
+        histogram.name = name;
+    }
+
+    qCDebug(PLASMA_NM) << "Resume latency for" << (name.isEmpty() ? key : name) << latency << "ms";
+}
+
+void ResumeTracker::load()
+{
+    KConfig config(QStringLiteral("plasma-nm-resumestats"), KConfig::SimpleConfig, QStandardPaths::GenericDataLocation);
+
+    for (const QString &groupName : config.groupList()) {
+        KConfigGroup group(&config, groupName);
+
+        Histogram histogram;
+        histogram.name = group.readEntry("Name", QString());
+        histogram.buckets = group.readEntry("Buckets", QList<int>()).toVector();
+        histogram.count = group.readEntry("Count", 0);
+        histogram.total = group.readEntry("Total", qint64(0));
+        histogram.max = group.readEntry("Max", qint64(0));
+
+        // Bucket bounds changed, the old data cannot be mapped to the new ones
+        if (histogram.buckets.size() != s_bucketBounds.size() + 1) {
+            continue;
+        }
+
+        m_histograms.insert(groupName, histogram);
+    }
+}
+
+void ResumeTracker::save()
+{
+    KConfig config(QStringLiteral("plasma-nm-resumestats"), KConfig::SimpleConfig, QStandardPaths::GenericDataLocation);
+
+    for (const QString &groupName : config.groupList()) {
+        if (!m_histograms.contains(groupName)) {
+            config.deleteGroup(groupName);
+        }
+    }
+
+    for (auto it = m_histograms.constBegin(); it != m_histograms.constEnd(); ++it) {
+        KConfigGroup group(&config, it.key());
+        group.writeEntry("Name", it->name);
+        group.writeEntry("Buckets", it->buckets.toList());
+        group.writeEntry("Count", it->count);
+        group.writeEntry("Total", it->total);
+        group.writeEntry("Max", it->max);
+    }
+
+    config.sync();
+}
@@ -0,0 +1,96 @@
+/*
+    Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLASMA_NM_RESUME_TRACKER_H
+#define PLASMA_NM_RESUME_TRACKER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QVariantMap>
+#include <QVector>
+
+#include <NetworkManagerQt/ActiveConnection>
+#include <NetworkManagerQt/Device>
+#include <NetworkManagerQt/Manager>
+
+class QTimer;
+
+/**
+ * Measures how long it takes to get back online after resume.
+ *
+ * Latencies from PrepareForSleep(false) until each connection gets activated
+ * and until NetworkManager reports full connectivity are collected into
+ * histograms which are persisted across sessions.
+ */
+class Q_DECL_EXPORT ResumeTracker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ResumeTracker(QObject *parent = nullptr);
+    ~ResumeTracker() override;
+
+    /**
+     * Returns histograms keyed by connection uuid, "connectivity" holds time until full connectivity
+     * and "lastResume" the timeline of the last resume
+     */
+    QVariantMap statistics() const;
+    void reset();
+
+private Q_SLOTS:
+    void onPrepareForSleep(bool sleep);
+    void addActiveConnection(const QString &path);
+    void addDevice(const QString &uni);
+    void onActiveConnectionStateChanged(NetworkManager::ActiveConnection::State state);
+    void onDeviceStateChanged(NetworkManager::Device::State newstate, NetworkManager::Device::State oldstate, NetworkManager::Device::StateChangeReason reason);
+    void onConnectivityChanged(NetworkManager::Connectivity connectivity);
+    void finishResume();
+
+private:
+    struct Histogram {
+        QString name;
+        QVector<int> buckets;
+        int count = 0;
+        qint64 total = 0;
+        qint64 max = 0;
+    };
+
+    void watchActiveConnection(const NetworkManager::ActiveConnection::Ptr &ac);
+    void watchDevice(const NetworkManager::Device::Ptr &device);
+    void recordEvent(const QString &event);
+    void recordLatency(const QString &key, const QString &name, qint64 latency);
+    void load();
+    void save();
+
+    bool m_resuming = false;
+    QElapsedTimer m_resumeTimer;
+    QTimer *m_resumeTimeout = nullptr;
+    // Connections which were active before going to sleep and are not back yet
+    QSet<QString> m_activeBeforeSleep;
+    QSet<QString> m_pendingConnections;
+    bool m_connectivityRecorded = false;
+    QStringList m_timeline;
+    QStringList m_lastTimeline;
+
+    QHash<QString, Histogram> m_histograms;
+};
+
+#endif // PLASMA_NM_RESUME_TRACKER_H
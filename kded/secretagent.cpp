@@ -23,6 +23,7 @@
 
 #include "passworddialog.h"
 #include "secretagent.h"
+#include "secretscache.h"
 
 #include "debug.h"
 
@@ -39,6 +40,7 @@
 #include <NetworkManagerQt/WireguardSetting>
 
 #include <QDBusConnection>
+#include <QSet>
 #include <QStringBuilder>
 #include <QDialog>
 #include <QDBusConnection>
@@ -56,15 +58,57 @@ SecretAgent::SecretAgent(QObject* parent)
     , m_openWalletFailed(false)
     , m_wallet(nullptr)
     , m_dialog(nullptr)
+    , m_secretsCache(nullptr)
+    , m_prefetchPending(false)
+    , m_lastRequestId(0)
+    , m_dialogRequest(0)
 {
     connect(NetworkManager::notifier(), &NetworkManager::Notifier::serviceDisappeared, this, &SecretAgent::killDialogs);
 
+    int secretsCacheTimeout = Configuration::secretsCacheTimeout();
+    if (secretsCacheTimeout == 0 && Configuration::prefetchSecrets()) {
+        // Prefetching is pointless without a place to keep the secrets
+        secretsCacheTimeout = 300;
+    }
+
+    if (secretsCacheTimeout > 0) {
+        m_secretsCache = new SecretsCache(secretsCacheTimeout);
+
+        // Cached secrets must not outlive a locked screen or a suspend
+        QDBusConnection::systemBus().connect(QStringLiteral("org.freedesktop.login1"),
+                                             QStringLiteral("/org/freedesktop/login1"),
+                                             QStringLiteral("org.freedesktop.login1.Manager"),
+                                             QStringLiteral("PrepareForSleep"),
+                                             this,
+                                             SLOT(prepareForSleep(bool)));
+        QDBusConnection::sessionBus().connect(QStringLiteral("org.freedesktop.ScreenSaver"),
+                                              QStringLiteral("/ScreenSaver"),
+                                              QStringLiteral("org.freedesktop.ScreenSaver"),
+                                              QStringLiteral("ActiveChanged"),
+                                              this,
+                                              SLOT(screenSaverActiveChanged(bool)));
+    }
+
     // We have to import secrets previously stored in plaintext files
     importSecretsFromPlainTextFiles();
 }
 
 SecretAgent::~SecretAgent()
 {
+    delete m_secretsCache;
+}
+
+void SecretAgent::prefetchSecrets()
+{
+    if (!m_secretsCache || !Configuration::prefetchSecrets()) {
+        return;
+    }
+
+    m_prefetchPending = true;
+    // Otherwise continues in walletOpened()
+    if (useWallet() && m_wallet->isOpen()) {
+        loadPrefetchedSecrets();
+    }
 }
 
 NMVariantMapMap SecretAgent::GetSecrets(const NMVariantMapMap &connection, const QDBusObjectPath &connection_path, const QString &setting_name,
@@ -77,12 +121,9 @@ NMVariantMapMap SecretAgent::GetSecrets(const NMVariantMapMap &connection, const
     qCDebug(PLASMA_NM) << "Flags:" << flags;
 
     const QString callId = connection_path.path() % setting_name;
-    for (const SecretsRequest &request : m_calls) {
-        if (request == callId) {
-            qCWarning(PLASMA_NM) << "GetSecrets was called again! This should not happen, cancelling first call" << connection_path.path() << setting_name;
-            CancelGetSecrets(connection_path, setting_name);
-            break;
-        }
+    if (m_getSecretsIndex.contains(callId)) {
+        qCWarning(PLASMA_NM) << "GetSecrets was called again! This should not happen, cancelling first call" << connection_path.path() << setting_name;
+        CancelGetSecrets(connection_path, setting_name);
     }
 
     setDelayedReply(true);
@@ -94,7 +135,8 @@ NMVariantMapMap SecretAgent::GetSecrets(const NMVariantMapMap &connection, const
     request.hints = hints;
     request.setting_name = setting_name;
     request.message = message();
-    m_calls << request;
+    request.timer.start();
+    enqueue(request);
 
     processNext();
     return NMVariantMapMap();
@@ -117,7 +159,7 @@ void SecretAgent::SaveSecrets(const NMVariantMapMap &connection, const QDBusObje
     request.connection = connection;
     request.connection_path = connection_path;
     request.message = message();
-    m_calls << request;
+    enqueue(request);
 
     processNext();
 }
@@ -133,7 +175,7 @@ void SecretAgent::DeleteSecrets(const NMVariantMapMap &connection, const QDBusOb
     request.connection = connection;
     request.connection_path = connection_path;
     request.message = message();
-    m_calls << request;
+    enqueue(request);
 
     processNext();
 }
@@ -144,20 +186,19 @@ void SecretAgent::CancelGetSecrets(const QDBusObjectPath &connection_path, const
     qCDebug(PLASMA_NM) << "Path:" << connection_path.path();
     qCDebug(PLASMA_NM) << "Setting name:" << setting_name;
 
-    QString callId = connection_path.path() % setting_name;
-    for (int i = 0; i < m_calls.size(); ++i) {
-        SecretsRequest request = m_calls.at(i);
-        if (request.type == SecretsRequest::GetSecrets && callId == request.callId) {
-            if (m_dialog == request.dialog) {
-                m_dialog = nullptr;
-            }
-            delete request.dialog;
-            sendError(SecretAgent::AgentCanceled,
-                      QLatin1String("Agent canceled the password dialog"),
-                      request.message);
-            m_calls.removeAt(i);
-            break;
+    const QString callId = connection_path.path() % setting_name;
+    const quint64 id = m_getSecretsIndex.value(callId);
+    auto it = m_calls.find(id);
+    if (it != m_calls.end()) {
+        if (m_dialog == it->dialog) {
+            m_dialog = nullptr;
+            m_dialogRequest = 0;
         }
+        delete it->dialog;
+        sendError(SecretAgent::AgentCanceled,
+                  QLatin1String("Agent canceled the password dialog"),
+                  it->message);
+        removeRequest(id);
     }
 
     processNext();
@@ -165,150 +206,156 @@ void SecretAgent::CancelGetSecrets(const QDBusObjectPath &connection_path, const
 
 void SecretAgent::dialogAccepted()
 {
-    for (int i = 0; i < m_calls.size(); ++i) {
-        SecretsRequest request = m_calls[i];
-        if (request.type == SecretsRequest::GetSecrets && request.dialog == m_dialog) {
-            NMStringMap tmpOpenconnectSecrets;
-            NMVariantMapMap connection = request.dialog->secrets();
-            if (connection.contains(QLatin1String("vpn"))) {
-                if (connection.value(QStringLiteral("vpn")).contains(QLatin1String("tmp-secrets"))) {
-                    QVariantMap vpnSetting = connection.value(QLatin1String("vpn"));
-                    tmpOpenconnectSecrets = qdbus_cast<NMStringMap>(vpnSetting.take(QLatin1String("tmp-secrets")));
-                    connection.insert(QLatin1String("vpn"), vpnSetting);
-                }
+    const quint64 id = m_dialogRequest;
+    auto it = m_calls.constFind(id);
+    if (it != m_calls.constEnd()) {
+        const SecretsRequest request = it.value();
+        NMStringMap tmpOpenconnectSecrets;
+        NMVariantMapMap connection = request.dialog->secrets();
+        if (connection.contains(QLatin1String("vpn"))) {
+            if (connection.value(QStringLiteral("vpn")).contains(QLatin1String("tmp-secrets"))) {
+                QVariantMap vpnSetting = connection.value(QLatin1String("vpn"));
+                tmpOpenconnectSecrets = qdbus_cast<NMStringMap>(vpnSetting.take(QLatin1String("tmp-secrets")));
+                connection.insert(QLatin1String("vpn"), vpnSetting);
             }
+        }
 
-            sendSecrets(connection, request.message);
-            NetworkManager::ConnectionSettings::Ptr connectionSettings = NetworkManager::ConnectionSettings::Ptr(new NetworkManager::ConnectionSettings(connection));
-            NetworkManager::ConnectionSettings::Ptr completeConnectionSettings;
-            NetworkManager::Connection::Ptr con = NetworkManager::findConnectionByUuid(connectionSettings->uuid());
-            if (con) {
-                completeConnectionSettings = con->settings();
-            } else {
-                completeConnectionSettings = connectionSettings;
-            }
-            if (request.saveSecretsWithoutReply && completeConnectionSettings->connectionType() != NetworkManager::ConnectionSettings::Vpn) {
-                bool requestOffline = true;
-                if (completeConnectionSettings->connectionType() == NetworkManager::ConnectionSettings::Gsm) {
-                    NetworkManager::GsmSetting::Ptr gsmSetting = completeConnectionSettings->setting(NetworkManager::Setting::Gsm).staticCast<NetworkManager::GsmSetting>();
-                    if (gsmSetting) {
-                        if (gsmSetting->passwordFlags().testFlag(NetworkManager::Setting::NotSaved) ||
-                            gsmSetting->passwordFlags().testFlag(NetworkManager::Setting::NotRequired)) {
-                            requestOffline = false;
-                        } else if (gsmSetting->pinFlags().testFlag(NetworkManager::Setting::NotSaved) ||
-                                   gsmSetting->pinFlags().testFlag(NetworkManager::Setting::NotRequired)) {
-                            requestOffline = false;
-                        }
+        sendSecrets(connection, request.message);
+        NetworkManager::ConnectionSettings::Ptr connectionSettings = NetworkManager::ConnectionSettings::Ptr(new NetworkManager::ConnectionSettings(connection));
+        NetworkManager::ConnectionSettings::Ptr completeConnectionSettings;
+        NetworkManager::Connection::Ptr con = NetworkManager::findConnectionByUuid(connectionSettings->uuid());
+        if (con) {
+            completeConnectionSettings = con->settings();
+        } else {
+            completeConnectionSettings = connectionSettings;
+        }
+        if (request.saveSecretsWithoutReply && completeConnectionSettings->connectionType() != NetworkManager::ConnectionSettings::Vpn) {
+            bool requestOffline = true;
+            if (completeConnectionSettings->connectionType() == NetworkManager::ConnectionSettings::Gsm) {
+                NetworkManager::GsmSetting::Ptr gsmSetting = completeConnectionSettings->setting(NetworkManager::Setting::Gsm).staticCast<NetworkManager::GsmSetting>();
+                if (gsmSetting) {
+                    if (gsmSetting->passwordFlags().testFlag(NetworkManager::Setting::NotSaved) ||
+                        gsmSetting->passwordFlags().testFlag(NetworkManager::Setting::NotRequired)) {
+                        requestOffline = false;
+                    } else if (gsmSetting->pinFlags().testFlag(NetworkManager::Setting::NotSaved) ||
+                               gsmSetting->pinFlags().testFlag(NetworkManager::Setting::NotRequired)) {
+                        requestOffline = false;
                     }
-                } else if (completeConnectionSettings->connectionType() == NetworkManager::ConnectionSettings::Wireless) {
-                    NetworkManager::WirelessSecuritySetting::Ptr wirelessSecuritySetting = completeConnectionSettings->setting(NetworkManager::Setting::WirelessSecurity).staticCast<NetworkManager::WirelessSecuritySetting>();
-                    if (wirelessSecuritySetting && wirelessSecuritySetting->keyMgmt() == NetworkManager::WirelessSecuritySetting::WpaEap) {
-                        NetworkManager::Security8021xSetting::Ptr security8021xSetting = completeConnectionSettings->setting(NetworkManager::Setting::Security8021x).staticCast<NetworkManager::Security8021xSetting>();
-                        if (security8021xSetting) {
-                            if (security8021xSetting->eapMethods().contains(NetworkManager::Security8021xSetting::EapMethodFast) ||
-                                security8021xSetting->eapMethods().contains(NetworkManager::Security8021xSetting::EapMethodTtls) ||
-                                security8021xSetting->eapMethods().contains(NetworkManager::Security8021xSetting::EapMethodPeap)) {
-                                if (security8021xSetting->passwordFlags().testFlag(NetworkManager::Setting::NotSaved) ||
-                                    security8021xSetting->passwordFlags().testFlag(NetworkManager::Setting::NotRequired)) {
-                                    requestOffline = false;
-                                }
+                }
+            } else if (completeConnectionSettings->connectionType() == NetworkManager::ConnectionSettings::Wireless) {
+                NetworkManager::WirelessSecuritySetting::Ptr wirelessSecuritySetting = completeConnectionSettings->setting(NetworkManager::Setting::WirelessSecurity).staticCast<NetworkManager::WirelessSecuritySetting>();
+                if (wirelessSecuritySetting && wirelessSecuritySetting->keyMgmt() == NetworkManager::WirelessSecuritySetting::WpaEap) {
+                    NetworkManager::Security8021xSetting::Ptr security8021xSetting = completeConnectionSettings->setting(NetworkManager::Setting::Security8021x).staticCast<NetworkManager::Security8021xSetting>();
+                    if (security8021xSetting) {
+                        if (security8021xSetting->eapMethods().contains(NetworkManager::Security8021xSetting::EapMethodFast) ||
+                            security8021xSetting->eapMethods().contains(NetworkManager::Security8021xSetting::EapMethodTtls) ||
+                            security8021xSetting->eapMethods().contains(NetworkManager::Security8021xSetting::EapMethodPeap)) {
+                            if (security8021xSetting->passwordFlags().testFlag(NetworkManager::Setting::NotSaved) ||
+                                security8021xSetting->passwordFlags().testFlag(NetworkManager::Setting::NotRequired)) {
+                                requestOffline = false;
                             }
                         }
                     }
                 }
+            }
 
-                if (requestOffline) {
-                    SecretsRequest requestOffline(SecretsRequest::SaveSecrets);
-                    requestOffline.connection = connection;
-                    requestOffline.connection_path = request.connection_path;
-                    requestOffline.saveSecretsWithoutReply = true;
-                    m_calls << requestOffline;
+            if (requestOffline) {
+                SecretsRequest requestOffline(SecretsRequest::SaveSecrets);
+                requestOffline.connection = connection;
+                requestOffline.connection_path = request.connection_path;
+                requestOffline.saveSecretsWithoutReply = true;
+                enqueue(requestOffline);
+            }
+        } else if (request.saveSecretsWithoutReply && completeConnectionSettings->connectionType() == NetworkManager::ConnectionSettings::Vpn && !tmpOpenconnectSecrets.isEmpty()) {
+            NetworkManager::VpnSetting::Ptr vpnSetting = completeConnectionSettings->setting(NetworkManager::Setting::Vpn).staticCast<NetworkManager::VpnSetting>();
+            if (vpnSetting) {
+                NMStringMap data = vpnSetting->data();
+                NMStringMap secrets = vpnSetting->secrets();
+
+                // Load secrets from auth dialog which are returned back to NM
+                if (connection.value(QLatin1String("vpn")).contains(QLatin1String("secrets"))) {
+                    secrets.unite(qdbus_cast<NMStringMap>(connection.value(QLatin1String("vpn")).value(QLatin1String("secrets"))));
                 }
-            } else if (request.saveSecretsWithoutReply && completeConnectionSettings->connectionType() == NetworkManager::ConnectionSettings::Vpn && !tmpOpenconnectSecrets.isEmpty()) {
-                NetworkManager::VpnSetting::Ptr vpnSetting = completeConnectionSettings->setting(NetworkManager::Setting::Vpn).staticCast<NetworkManager::VpnSetting>();
-                if (vpnSetting) {
-                    NMStringMap data = vpnSetting->data();
-                    NMStringMap secrets = vpnSetting->secrets();
-
-                    // Load secrets from auth dialog which are returned back to NM
-                    if (connection.value(QLatin1String("vpn")).contains(QLatin1String("secrets"))) {
-                        secrets.unite(qdbus_cast<NMStringMap>(connection.value(QLatin1String("vpn")).value(QLatin1String("secrets"))));
-                    }
 
-                    // Load temporary secrets from auth dialog which are not returned to NM
-                    for (const QString &key : tmpOpenconnectSecrets.keys()) {
-                        if (secrets.contains(QLatin1String("save_passwords")) && secrets.value(QLatin1String("save_passwords")) == QLatin1String("yes")) {
-                            data.insert(key + QLatin1String("-flags"), QString::number(NetworkManager::Setting::AgentOwned));
-                        } else {
-                            data.insert(key + QLatin1String("-flags"), QString::number(NetworkManager::Setting::NotSaved));
-                        }
-                        secrets.insert(key, tmpOpenconnectSecrets.value(key));
+                // Load temporary secrets from auth dialog which are not returned to NM
+                for (const QString &key : tmpOpenconnectSecrets.keys()) {
+                    if (secrets.contains(QLatin1String("save_passwords")) && secrets.value(QLatin1String("save_passwords")) == QLatin1String("yes")) {
+                        data.insert(key + QLatin1String("-flags"), QString::number(NetworkManager::Setting::AgentOwned));
+                    } else {
+                        data.insert(key + QLatin1String("-flags"), QString::number(NetworkManager::Setting::NotSaved));
                     }
+                    secrets.insert(key, tmpOpenconnectSecrets.value(key));
+                }
 
-                    vpnSetting->setData(data);
-                    vpnSetting->setSecrets(secrets);
-                    if (!con) {
-                        con = NetworkManager::findConnection(request.connection_path.path());
-                    }
+                vpnSetting->setData(data);
+                vpnSetting->setSecrets(secrets);
+                if (!con) {
+                    con = NetworkManager::findConnection(request.connection_path.path());
+                }
 
-                    if (con) {
-                        con->update(completeConnectionSettings->toMap());
-                    }
+                if (con) {
+                    con->update(completeConnectionSettings->toMap());
                 }
             }
-
-            m_calls.removeAt(i);
-            break;
         }
+
+        removeRequest(id);
     }
 
     m_dialog->deleteLater();
     m_dialog = nullptr;
+    m_dialogRequest = 0;
 
     processNext();
 }
 
 void SecretAgent::dialogRejected()
 {
-    for (int i = 0; i < m_calls.size(); ++i) {
-        SecretsRequest request = m_calls[i];
-        if (request.type == SecretsRequest::GetSecrets && request.dialog == m_dialog) {
-            sendError(SecretAgent::UserCanceled,
-                      QLatin1String("User canceled the password dialog"),
-                      request.message);
-            m_calls.removeAt(i);
-            break;
-        }
+    const quint64 id = m_dialogRequest;
+    auto it = m_calls.constFind(id);
+    if (it != m_calls.constEnd()) {
+        sendError(SecretAgent::UserCanceled,
+                  QLatin1String("User canceled the password dialog"),
+                  it->message);
+        removeRequest(id);
     }
 
     m_dialog->deleteLater();
     m_dialog = nullptr;
+    m_dialogRequest = 0;
 
     processNext();
 }
 
 void SecretAgent::killDialogs()
 {
-    int i = 0;
-    while (i < m_calls.size()) {
-        SecretsRequest request = m_calls[i];
-        if (request.type == SecretsRequest::GetSecrets) {
-            delete request.dialog;
-            m_calls.removeAt(i);
+    auto it = m_calls.begin();
+    while (it != m_calls.end()) {
+        if (it->type == SecretsRequest::GetSecrets) {
+            delete it->dialog;
+            m_getSecretsIndex.remove(it->callId);
+            it = m_calls.erase(it);
+        } else {
+            ++it;
         }
-
-        ++i;
     }
+
+    m_dialog = nullptr;
+    m_dialogRequest = 0;
 }
 
 void SecretAgent::walletOpened(bool success)
 {
     if (!success) {
         m_openWalletFailed = true;
+        m_prefetchPending = false;
         m_wallet->deleteLater();
         m_wallet = nullptr;
     } else {
         m_openWalletFailed = false;
+        if (m_prefetchPending) {
+            loadPrefetchedSecrets();
+        }
     }
 
     processNext();
@@ -320,40 +367,91 @@ void SecretAgent::walletClosed()
         m_wallet->deleteLater();
     }
     m_wallet = nullptr;
+
+    // Don't keep serving wallet secrets once the user closed the wallet
+    if (m_secretsCache) {
+        qCDebug(PLASMA_NM) << "Wallet closed, wiping secrets cache";
+        m_secretsCache->clear();
+    }
+}
+
+void SecretAgent::prepareForSleep(bool sleep)
+{
+    if (sleep && m_secretsCache) {
+        qCDebug(PLASMA_NM) << "Going to sleep, wiping secrets cache";
+        m_secretsCache->clear();
+    }
+}
+
+void SecretAgent::screenSaverActiveChanged(bool active)
+{
+    if (active && m_secretsCache) {
+        qCDebug(PLASMA_NM) << "Screen locked, wiping secrets cache";
+        m_secretsCache->clear();
+    }
+}
+
+quint64 SecretAgent::enqueue(const SecretsRequest &request)
+{
+    const quint64 id = ++m_lastRequestId;
+    auto it = m_calls.insert(id, request);
+    it->id = id;
+    if (request.type == SecretsRequest::GetSecrets) {
+        m_getSecretsIndex.insert(request.callId, id);
+    }
+
+    return id;
+}
+
+void SecretAgent::removeRequest(quint64 id)
+{
+    auto it = m_calls.find(id);
+    if (it == m_calls.end()) {
+        return;
+    }
+
+    if (it->type == SecretsRequest::GetSecrets && m_getSecretsIndex.value(it->callId) == id) {
+        m_getSecretsIndex.remove(it->callId);
+    }
+    m_calls.erase(it);
 }
 
 void SecretAgent::processNext()
 {
-    int i = 0;
-    while (i < m_calls.size()) {
-        SecretsRequest &request = m_calls[i];
-        switch (request.type) {
+    // Requests may be added or removed while processing (dialogs, cancellation), so walk a snapshot of ids
+    const QList<quint64> ids = m_calls.keys();
+    for (const quint64 id : ids) {
+        auto it = m_calls.find(id);
+        if (it == m_calls.end()) {
+            continue;
+        }
+
+        bool processed = false;
+        switch (it->type) {
         case SecretsRequest::GetSecrets:
-            if (processGetSecrets(request)) {
-                m_calls.removeAt(i);
-                continue;
+            processed = processGetSecrets(*it);
+            if (processed) {
+                qCDebug(PLASMA_NM) << "GetSecrets for" << it->connection_path.path() << it->setting_name << "answered after" << it->timer.elapsed() << "ms";
             }
             break;
         case SecretsRequest::SaveSecrets:
-            if (processSaveSecrets(request)) {
-                m_calls.removeAt(i);
-                continue;
-            }
+            processed = processSaveSecrets(*it);
             break;
         case SecretsRequest::DeleteSecrets:
-            if (processDeleteSecrets(request)) {
-                m_calls.removeAt(i);
-                continue;
-            }
+            processed = processDeleteSecrets(*it);
             break;
         }
-        ++i;
+
+        if (processed) {
+            removeRequest(id);
+        }
     }
 }
 
 bool SecretAgent::processGetSecrets(SecretsRequest &request)
 {
-    if (m_dialog) {
+    // Interactive requests are serialized behind the dialog, the rest is answered right away
+    if (request.interactive && m_dialog) {
         return false;
     }
 
@@ -390,11 +488,21 @@ bool SecretAgent::processGetSecrets(SecretsRequest &request)
     }
 
     NMStringMap secretsMap;
-    if (!requestNew && useWallet()) {
+    const QString key = QLatin1Char('{') % connectionSettings->uuid() % QLatin1Char('}') % QLatin1Char(';') % request.setting_name;
+    if (requestNew && m_secretsCache) {
+        // NM is asking for new secrets, what we have is most likely wrong
+        m_secretsCache->remove(key);
+    }
+
+    if (!requestNew && m_secretsCache && m_secretsCache->lookup(key, secretsMap)) {
+        qCDebug(PLASMA_NM) << Q_FUNC_INFO << "Using cached secrets";
+    } else if (!requestNew && useWallet()) {
         if (m_wallet->isOpen()) {
             if (m_wallet->hasFolder("Network Management") && m_wallet->setFolder("Network Management")) {
-                QString key = QLatin1Char('{') % connectionSettings->uuid() % QLatin1Char('}') % QLatin1Char(';') % request.setting_name;
                 m_wallet->readMap(key, secretsMap);
+                if (m_secretsCache) {
+                    m_secretsCache->insert(key, secretsMap);
+                }
             }
         } else {
             qCDebug(PLASMA_NM) << Q_FUNC_INFO << "Waiting for the wallet to open";
@@ -434,6 +542,11 @@ bool SecretAgent::processGetSecrets(SecretsRequest &request)
         sendSecrets(result, request.message);
         return true;
     } else if (requestNew || (allowInteraction && !setting->needSecrets(requestNew).isEmpty()) || (allowInteraction && userRequested) || (isVpn && allowInteraction)) {
+        request.interactive = true;
+        if (m_dialog) {
+            return false;
+        }
+
         m_dialog = new PasswordDialog(connectionSettings, request.flags, request.setting_name);
         connect(m_dialog, &PasswordDialog::accepted, this, &SecretAgent::dialogAccepted);
         connect(m_dialog, &PasswordDialog::rejected, this, &SecretAgent::dialogRejected);
@@ -447,6 +560,7 @@ bool SecretAgent::processGetSecrets(SecretsRequest &request)
             return true;
         } else {
             request.dialog = m_dialog;
+            m_dialogRequest = request.id;
             request.saveSecretsWithoutReply = !connectionSettings->permissions().isEmpty();
             //m_dialog->show();
             
@@ -512,6 +626,9 @@ bool SecretAgent::processSaveSecrets(SecretsRequest &request) const
                     if (!secretsMap.isEmpty()) {
                         QString entryName = QLatin1Char('{') % connectionSettings.uuid() % QLatin1Char('}') % QLatin1Char(';') % setting->name();
                         m_wallet->writeMap(entryName, secretsMap);
+                        if (m_secretsCache) {
+                            m_secretsCache->insert(entryName, secretsMap);
+                        }
                     }
                 }
             } else if (!request.saveSecretsWithoutReply) {
@@ -538,6 +655,10 @@ bool SecretAgent::processSaveSecrets(SecretsRequest &request) const
 
 bool SecretAgent::processDeleteSecrets(SecretsRequest &request) const
 {
+    if (m_secretsCache) {
+        m_secretsCache->removeConnection(NetworkManager::ConnectionSettings(request.connection).uuid());
+    }
+
     if (useWallet()) {
         if (m_wallet->isOpen()) {
             if (m_wallet->hasFolder("Network Management") && m_wallet->setFolder("Network Management")) {
@@ -607,6 +728,53 @@ bool SecretAgent::hasSecrets(const NMVariantMapMap &connection) const
     return false;
 }
 
+void SecretAgent::loadPrefetchedSecrets()
+{
+    m_prefetchPending = false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!m_wallet->hasFolder("Network Management") || !m_wallet->setFolder("Network Management")) {
+        return;
+    }
+
+    QSet<QString> uuids;
+    for (const NetworkManager::Connection::Ptr &connection : NetworkManager::listConnections()) {
+        NetworkManager::ConnectionSettings::Ptr settings = connection->settings();
+        if (!settings->autoconnect()) {
+            continue;
+        }
+
+        switch (settings->connectionType()) {
+        case NetworkManager::ConnectionSettings::Wired:
+        case NetworkManager::ConnectionSettings::Wireless:
+        case NetworkManager::ConnectionSettings::Vpn:
+            uuids << settings->uuid();
+            break;
+        default:
+            break;
+        }
+    }
+
+    int loaded = 0;
+    for (const QString &entry : m_wallet->entryList()) {
+        // Entries are named "{uuid};setting"
+        const QString uuid = entry.section(QLatin1Char(';'), 0, 0).remove(QLatin1Char('{')).remove(QLatin1Char('}'));
+        if (!uuids.contains(uuid)) {
+            continue;
+        }
+
+        NMStringMap secretsMap;
+        if (m_wallet->readMap(entry, secretsMap) == 0 && !secretsMap.isEmpty()) {
+            m_secretsCache->insert(entry, secretsMap);
+            ++loaded;
+        }
+    }
+
+    qCDebug(PLASMA_NM) << "Prefetched" << loaded << "secrets for" << uuids.size() << "connections in" << timer.elapsed() << "ms";
+}
+
 void SecretAgent::sendSecrets(const NMVariantMapMap &secrets, const QDBusMessage &message) const
 {
     QDBusMessage reply;
@@ -25,11 +25,16 @@
 
 #include <NetworkManagerQt/SecretAgent>
 
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
+
 namespace KWallet {
 class Wallet;
 }
 
 class PasswordDialog;
+class SecretsCache;
 
 class SecretsRequest {
 public:
@@ -40,14 +45,17 @@ public:
     };
     explicit SecretsRequest(Type _type) :
         type(_type),
+        id(0),
         flags(NetworkManager::SecretAgent::None),
         saveSecretsWithoutReply(false),
+        interactive(false),
         dialog(nullptr)
     {}
     inline bool operator==(const QString &other) const {
         return callId == other;
     }
     Type type;
+    quint64 id;
     QString callId;
     NMVariantMapMap connection;
     QDBusObjectPath connection_path;
@@ -61,8 +69,15 @@ public:
      * should skip the DBus reply.
      */
     bool saveSecretsWithoutReply;
+    /**
+     * Set once the request is known to need the password dialog,
+     * such requests are processed one at a time.
+     */
+    bool interactive;
     QDBusMessage message;
     PasswordDialog *dialog;
+    // Started when the request arrives, used to report how long NM waited for the reply
+    QElapsedTimer timer;
 };
 
 class Q_DECL_EXPORT SecretAgent : public NetworkManager::SecretAgent
@@ -72,6 +87,14 @@ public:
     explicit SecretAgent(QObject* parent = nullptr);
     ~SecretAgent() override;
 
+    /**
+     * Opens the wallet and loads secrets of connections which are activated
+     * automatically into the secrets cache, so the first request after login
+     * doesn't have to wait for the wallet. Does nothing unless enabled in the
+     * configuration.
+     */
+    void prefetchSecrets();
+
 Q_SIGNALS:
     void secretsError(const QString &connectionPath, const QString &message) const;
 
@@ -87,8 +110,16 @@ private Q_SLOTS:
     void killDialogs();
     void walletOpened(bool success);
     void walletClosed();
+    void prepareForSleep(bool sleep);
+    void screenSaverActiveChanged(bool active);
 
 private:
+    /**
+     * @brief enqueue adds the request to the queue
+     * @return id of the request, requests are processed in the order of their ids
+     */
+    quint64 enqueue(const SecretsRequest &request);
+    void removeRequest(quint64 id);
     void processNext();
     /**
      * @brief processGetSecrets requests
@@ -114,12 +145,22 @@ private:
      * @return true if the connection has secrets, false otherwise
      */
     bool hasSecrets(const NMVariantMapMap &connection) const;
+    void loadPrefetchedSecrets();
     void sendSecrets(const NMVariantMapMap &secrets, const QDBusMessage &message) const;
 
     mutable bool m_openWalletFailed;
     mutable KWallet::Wallet *m_wallet;
     mutable PasswordDialog *m_dialog;
-    QList<SecretsRequest> m_calls;
+    // Only set when enabled in the configuration
+    SecretsCache *m_secretsCache;
+    bool m_prefetchPending;
+    // Pending requests ordered by their id, GetSecrets requests are also
+    // indexed by connection path + setting name
+    QMap<quint64, SecretsRequest> m_calls;
+    QHash<QString, quint64> m_getSecretsIndex;
+    quint64 m_lastRequestId;
+    // Request owning m_dialog, 0 when there is none
+    quint64 m_dialogRequest;
 
     void importSecretsFromPlainTextFiles();
 
@@ -0,0 +1,230 @@
+/*
+    Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "secretscache.h"
+
+#include "debug.h"
+
+#include <QDateTime>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+
+static void wipe(void *data, size_t size)
+{
+    // Volatile access so the compiler cannot drop the stores as dead
+    volatile char *p = static_cast<volatile char *>(data);
+    while (size--) {
+        *p++ = 0;
+    }
+}
+
+// Entries are a count followed by length-prefixed UTF-16 keys and values, written
+// straight into the locked region so no copy of the secrets is left on the heap
+static size_t serializedSize(const NMStringMap &secrets)
+{
+    size_t size = sizeof(quint32);
+    for (auto it = secrets.constBegin(); it != secrets.constEnd(); ++it) {
+        size += 2 * sizeof(quint32) + (it.key().size() + it.value().size()) * sizeof(QChar);
+    }
+    return size;
+}
+
+static void writeUInt(char *&p, quint32 value)
+{
+    memcpy(p, &value, sizeof(value));
+    p += sizeof(value);
+}
+
+static void writeString(char *&p, const QString &string)
+{
+    writeUInt(p, string.size());
+    memcpy(p, string.constData(), string.size() * sizeof(QChar));
+    p += string.size() * sizeof(QChar);
+}
+
+static bool readUInt(const char *&p, const char *end, quint32 &value)
+{
+    if (size_t(end - p) < sizeof(value)) {
+        return false;
+    }
+    memcpy(&value, p, sizeof(value));
+    p += sizeof(value);
+    return true;
+}
+
+static bool readString(const char *&p, const char *end, QString &string)
+{
+    quint32 length;
+    if (!readUInt(p, end, length) || size_t(end - p) / sizeof(QChar) < length) {
+        return false;
+    }
+    string.resize(length);
+    memcpy(string.data(), p, length * sizeof(QChar));
+    p += length * sizeof(QChar);
+    return true;
+}
+
+SecretsCache::SecretsCache(int timeout)
+    : m_timeout(qint64(timeout) * 1000)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+SecretsCache::~SecretsCache()
+{
+    clear();
+}
+
+bool SecretsCache::lookup(const QString &key, NMStringMap &secrets)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        ++m_misses;
+        return false;
+    }
+
+    if (it->expiration < QDateTime::currentMSecsSinceEpoch()) {
+        release(it.value());
+        m_entries.erase(it);
+        ++m_misses;
+        return false;
+    }
+
+    const char *p = it->data;
+    const char *end = it->data + it->size;
+    quint32 count = 0;
+    bool decoded = readUInt(p, end, count);
+    secrets.clear();
+    for (quint32 i = 0; decoded && i < count; ++i) {
+        QString secretKey;
+        QString secretValue;
+        decoded = readString(p, end, secretKey) && readString(p, end, secretValue);
+        if (decoded) {
+            secrets.insert(secretKey, secretValue);
+        }
+    }
+
+    // Never hand out partial secrets, let them be requested again instead
+    if (!decoded) {
+        qCWarning(PLASMA_NM) << "Dropping corrupted secrets cache entry for" << key;
+        secrets.clear();
+        release(it.value());
+        m_entries.erase(it);
+        ++m_misses;
+        return false;
+    }
+
+    ++m_hits;
+    qCDebug(PLASMA_NM) << "Secrets cache hit for" << key << "hits:" << m_hits << "misses:" << m_misses;
+    return true;
+}
+
+void SecretsCache::insert(const QString &key, const NMStringMap &secrets)
+{
+    remove(key);
+
+    if (secrets.isEmpty()) {
+        return;
+    }
+
+    const size_t pageSize = sysconf(_SC_PAGESIZE);
+    Entry entry;
+    entry.size = serializedSize(secrets);
+    entry.capacity = ((entry.size + pageSize - 1) / pageSize) * pageSize;
+    entry.expiration = QDateTime::currentMSecsSinceEpoch() + m_timeout;
+
+    void *data = mmap(nullptr, entry.capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+        return;
+    }
+
+    // Secrets must never end up in swap, don't cache them when we can't guarantee that
+    if (mlock(data, entry.capacity) != 0) {
+        qCWarning(PLASMA_NM) << "Failed to lock memory for the secrets cache, not caching" << key;
+        munmap(data, entry.capacity);
+        return;
+    }
+#ifdef MADV_DONTDUMP
+    madvise(data, entry.capacity, MADV_DONTDUMP);
+#endif
+
+    entry.data = static_cast<char *>(data);
+    char *p = entry.data;
+    writeUInt(p, secrets.size());
+    for (auto it = secrets.constBegin(); it != secrets.constEnd(); ++it) {
+        writeString(p, it.key());
+        writeString(p, it.value());
+    }
+
+    m_entries.insert(key, entry);
+}
+
+void SecretsCache::remove(const QString &key)
+{
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        release(it.value());
+        m_entries.erase(it);
+    }
+}
+
+void SecretsCache::removeConnection(const QString &uuid)
+{
+    const QString prefix = QLatin1Char('{') + uuid + QLatin1Char('}');
+    auto it = m_entries.begin();
+    while (it != m_entries.end()) {
+        if (it.key().startsWith(prefix)) {
+            release(it.value());
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void SecretsCache::clear()
+{
+    for (Entry &entry : m_entries) {
+        release(entry);
+    }
+    m_entries.clear();
+}
+
+quint64 SecretsCache::hits() const
+{
+    return m_hits;
+}
+
+quint64 SecretsCache::misses() const
+{
+    return m_misses;
+}
+
+void SecretsCache::release(Entry &entry)
+{
+    wipe(entry.data, entry.capacity);
+    munlock(entry.data, entry.capacity);
+    munmap(entry.data, entry.capacity);
+    entry.data = nullptr;
+}
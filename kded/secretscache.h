@@ -0,0 +1,78 @@
+/*
+    Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLASMA_NM_SECRETS_CACHE_H
+#define PLASMA_NM_SECRETS_CACHE_H
+
+#include <NetworkManagerQt/GenericTypes>
+
+#include <QHash>
+
+/**
+ * In-memory copy of secrets read from the wallet.
+ *
+ * Entries are keyed the same way as in the wallet ("{uuid};setting"), expire
+ * after a timeout and are kept serialized in memory which is locked (never
+ * swapped out), excluded from core dumps and wiped when released.
+ */
+class SecretsCache
+{
+public:
+    /**
+     * @timeout - lifetime of an entry in seconds
+     */
+    explicit SecretsCache(int timeout);
+    ~SecretsCache();
+
+    /**
+     * Returns true and fills @secrets when a valid entry for @key exists
+     */
+    bool lookup(const QString &key, NMStringMap &secrets);
+    void insert(const QString &key, const NMStringMap &secrets);
+    void remove(const QString &key);
+    /**
+     * Removes all entries of the connection with given uuid
+     */
+    void removeConnection(const QString &uuid);
+    /**
+     * Wipes all entries
+     */
+    void clear();
+
+    quint64 hits() const;
+    quint64 misses() const;
+
+private:
+    struct Entry {
+        char *data;
+        size_t size;
+        size_t capacity;
+        qint64 expiration;
+    };
+
+    static void release(Entry &entry);
+
+    QHash<QString, Entry> m_entries;
+    qint64 m_timeout;
+    quint64 m_hits;
+    quint64 m_misses;
+};
+
+#endif // PLASMA_NM_SECRETS_CACHE_H
@@ -25,16 +25,26 @@
 
 #include <KPluginFactory>
 
+#include <NetworkManagerQt/Manager>
+
+#include "debug.h"
+
 #include "secretagent.h"
 #include "notification.h"
 #include "monitor.h"
 #include "portalmonitor.h"
+#include "resumetracker.h"
 
 #include <QDBusMetaType>
 #include <QDBusServiceWatcher>
 #include <QDBusConnection>
 #include <QDBusConnectionInterface>
 #include <QDBusReply>
+#include <QElapsedTimer>
+#include <QTimer>
+
+// Monitors are created at the latest this long after the module got registered, in ms
+#define MONITORS_DELAY 10000
 
 K_PLUGIN_CLASS_WITH_JSON(NetworkManagementService, "networkmanagement.json")
 
@@ -45,6 +55,22 @@ class NetworkManagementServicePrivate
     Notification *notification = nullptr;
     Monitor *monitor = nullptr;
     PortalMonitor *portalMonitor = nullptr;
+    ResumeTracker *resumeTracker = nullptr;
+    bool secretsPrefetched = false;
+    bool monitorsScheduled = false;
+    bool monitorsCreated = false;
+    QList<QMetaObject::Connection> monitorsTriggers;
+
+    // Time spent in each startup stage, in ms
+    QElapsedTimer startupTimer;
+    QVariantMap startupTimings;
+
+    void recordStage(const QString &stage, const QElapsedTimer &stageTimer)
+    {
+        startupTimings.insert(stage, stageTimer.elapsed());
+        qCDebug(PLASMA_NM) << "Startup stage" << stage << "took" << stageTimer.elapsed() << "ms,"
+                           << startupTimer.elapsed() << "ms since the module was loaded";
+    }
 };
 
 NetworkManagementService::NetworkManagementService(QObject * parent, const QVariantList&)
@@ -52,10 +78,21 @@ NetworkManagementService::NetworkManagementService(QObject * parent, const QVari
 {
     Q_D(NetworkManagementService);
 
+    d->startupTimer.start();
+
     connect(this, &KDEDModule::moduleRegistered, this, &NetworkManagementService::init);
 
+    // The secret agent is the only part NetworkManager may need during login, register it first
+    QElapsedTimer stageTimer;
+    stageTimer.start();
     d->agent = new SecretAgent(this);
     connect(d->agent, &SecretAgent::secretsError, this, &NetworkManagementService::secretsError);
+    d->recordStage(QStringLiteral("agent"), stageTimer);
+
+    // Clients like the applet call the monitor over D-Bus right away, only its work is deferred
+    stageTimer.start();
+    d->monitor = new Monitor(this);
+    d->recordStage(QStringLiteral("monitorInterface"), stageTimer);
 }
 
 NetworkManagementService::~NetworkManagementService()
@@ -67,16 +104,106 @@ void NetworkManagementService::init()
 {
     Q_D(NetworkManagementService);
 
-    if (!d->notification) {
-        d->notification = new Notification(this);
+    if (!d->secretsPrefetched) {
+        d->secretsPrefetched = true;
+        d->agent->prefetchSecrets();
     }
 
-    if (!d->monitor) {
-        d->monitor = new Monitor(this);
+    // Monitors and notifications are not needed to get online, keep them off the session
+    // startup path. They are created after a delay, or as soon as NetworkManager has
+    // something to report for them, whatever comes first. Objects they watch are picked
+    // up from the current state when they are created.
+    if (!d->monitorsScheduled) {
+        d->monitorsScheduled = true;
+        QTimer::singleShot(MONITORS_DELAY, this, [this] () {
+            initMonitors(QStringLiteral("delay"));
+        });
+
+        NetworkManager::Notifier *notifier = NetworkManager::notifier();
+        d->monitorsTriggers << connect(notifier, &NetworkManager::Notifier::deviceAdded, this, [this] () {
+            initMonitors(QStringLiteral("deviceAdded"));
+        });
+        d->monitorsTriggers << connect(notifier, &NetworkManager::Notifier::activeConnectionAdded, this, [this] () {
+            initMonitors(QStringLiteral("activeConnectionAdded"));
+        });
+        d->monitorsTriggers << connect(notifier, &NetworkManager::Notifier::connectivityChanged, this, [this] () {
+            initMonitors(QStringLiteral("connectivityChanged"));
+        });
+        d->monitorsTriggers << connect(notifier, &NetworkManager::Notifier::statusChanged, this, [this] () {
+            initMonitors(QStringLiteral("statusChanged"));
+        });
+    }
+}
+
+void NetworkManagementService::initMonitors(const QString &trigger)
+{
+    Q_D(NetworkManagementService);
+
+    if (d->monitorsCreated) {
+        return;
+    }
+    d->monitorsCreated = true;
+
+    for (const QMetaObject::Connection &connection : qAsConst(d->monitorsTriggers)) {
+        disconnect(connection);
+    }
+    d->monitorsTriggers.clear();
+
+    qCDebug(PLASMA_NM) << "Creating monitors, triggered by" << trigger;
+    d->startupTimings.insert(QStringLiteral("monitorsTrigger"), trigger);
+    d->startupTimings.insert(QStringLiteral("monitorsStart"), d->startupTimer.elapsed());
+
+    QElapsedTimer stageTimer;
+
+    stageTimer.start();
+    d->monitor->startMonitoring();
+    d->recordStage(QStringLiteral("monitor"), stageTimer);
+
+    if (!d->notification) {
+        stageTimer.start();
+        d->notification = new Notification(this);
+        d->recordStage(QStringLiteral("notification"), stageTimer);
     }
 
     if (!d->portalMonitor) {
+        stageTimer.start();
         d->portalMonitor = new PortalMonitor(this);
+        d->recordStage(QStringLiteral("portalMonitor"), stageTimer);
+    }
+
+    if (!d->resumeTracker) {
+        stageTimer.start();
+        d->resumeTracker = new ResumeTracker(this);
+        d->recordStage(QStringLiteral("resumeTracker"), stageTimer);
+    }
+
+    d->startupTimings.insert(QStringLiteral("total"), d->startupTimer.elapsed());
+}
+
+QVariantMap NetworkManagementService::startupTimings() const
+{
+    Q_D(const NetworkManagementService);
+
+    return d->startupTimings;
+}
+
+QVariantMap NetworkManagementService::resumeLatencies() const
+{
+    Q_D(const NetworkManagementService);
+
+    if (!d->resumeTracker) {
+        return {};
+    }
+
+    return d->resumeTracker->statistics();
+}
+
+void NetworkManagementService::resetResumeLatencies()
+{
+    Q_D(NetworkManagementService);
+
+    if (d->resumeTracker) {
+        d->resumeTracker->reset();
     }
 }
 
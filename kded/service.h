@@ -42,12 +42,26 @@ public:
 
 public Q_SLOTS:
     Q_SCRIPTABLE void init();
+    /**
+     * Returns how long each startup stage took in ms, "total" is the time from
+     * loading the module until all stages finished. "monitorsTrigger" tells what
+     * started the deferred stages (the delay or a NetworkManager signal) and
+     * "monitorsStart" when it happened
+     */
+    Q_SCRIPTABLE QVariantMap startupTimings() const;
+    /**
+     * Returns histograms of the time it took to reconnect after resume, see ResumeTracker
+     */
+    Q_SCRIPTABLE QVariantMap resumeLatencies() const;
+    Q_SCRIPTABLE void resetResumeLatencies();
 
 Q_SIGNALS:
     Q_SCRIPTABLE
     void secretsError(const QString &connectionPath, const QString &message);
 
 private:
+    void initMonitors(const QString &trigger);
+
     NetworkManagementServicePrivate * const d_ptr;
 };
 
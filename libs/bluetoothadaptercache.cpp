@@ -0,0 +1,208 @@
+/*
+    Copyright 2021  Wang Rui <wangrui@jingos.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bluetoothadaptercache.h"
+#include "debug.h"
+
+#include <NetworkManagerQt/GenericTypes>
+
+#include <QDBusArgument>
+#include <QDBusMessage>
+#include <QDBusMetaType>
+#include <QDBusObjectPath>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusServiceWatcher>
+#include <QDBusVariant>
+
+#define BLUEZ_ADAPTER_IFACE "org.bluez.Adapter1"
+#define DBUS_OBJECT_MANAGER_IFACE "org.freedesktop.DBus.ObjectManager"
+#define DBUS_PROPERTIES_IFACE "org.freedesktop.DBus.Properties"
+
+typedef QMap<QDBusObjectPath, NMVariantMapMap> ManagedObjects;
+
+BluetoothAdapterCache::BluetoothAdapterCache(QObject *parent)
+    : BluetoothAdapterCache(QDBusConnection::systemBus(), QStringLiteral("org.bluez"), parent)
+{
+}
+
+BluetoothAdapterCache::BluetoothAdapterCache(const QDBusConnection &bus, const QString &service, QObject *parent)
+    : QObject(parent)
+    , m_bus(bus)
+    , m_service(service)
+    , m_ready(false)
+{
+    qDBusRegisterMetaType<ManagedObjects>();
+
+    m_bus.connect(m_service, QStringLiteral("/"), QStringLiteral(DBUS_OBJECT_MANAGER_IFACE), QStringLiteral("InterfacesAdded"),
+                  this, SLOT(interfacesAdded(QDBusMessage)));
+    m_bus.connect(m_service, QStringLiteral("/"), QStringLiteral(DBUS_OBJECT_MANAGER_IFACE), QStringLiteral("InterfacesRemoved"),
+                  this, SLOT(interfacesRemoved(QDBusMessage)));
+    // Empty path, we want to hear about all adapters, but not about devices which
+    // change their properties (RSSI) all the time during discovery
+    m_bus.connect(m_service, QString(), QStringLiteral(DBUS_PROPERTIES_IFACE), QStringLiteral("PropertiesChanged"),
+                  QStringList { QStringLiteral(BLUEZ_ADAPTER_IFACE) }, QString(),
+                  this, SLOT(propertiesChanged(QDBusMessage)));
+
+    m_serviceWatcher = new QDBusServiceWatcher(m_service, m_bus, QDBusServiceWatcher::WatchForOwnerChange, this);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceRegistered, this, &BluetoothAdapterCache::init);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &BluetoothAdapterCache::reset);
+
+    init();
+}
+
+BluetoothAdapterCache::~BluetoothAdapterCache()
+{
+}
+
+bool BluetoothAdapterCache::isReady() const
+{
+    return m_ready;
+}
+
+QMap<QString, bool> BluetoothAdapterCache::adapters() const
+{
+    return m_adapters;
+}
+
+void BluetoothAdapterCache::setPowered(const QString &adapter, bool powered)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(m_service, adapter, QStringLiteral(DBUS_PROPERTIES_IFACE), QStringLiteral("Set"));
+    const QList<QVariant> arguments { QLatin1String(BLUEZ_ADAPTER_IFACE), QLatin1String("Powered"), QVariant::fromValue(QDBusVariant(QVariant(powered))) };
+    message.setArguments(arguments);
+    m_bus.asyncCall(message);
+}
+
+void BluetoothAdapterCache::init()
+{
+    const QDBusMessage getObjects = QDBusMessage::createMethodCall(m_service, QStringLiteral("/"), QStringLiteral(DBUS_OBJECT_MANAGER_IFACE), QStringLiteral("GetManagedObjects"));
+    QDBusPendingReply<ManagedObjects> reply = m_bus.asyncCall(getObjects);
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &BluetoothAdapterCache::managedObjectsReceived);
+}
+
+void BluetoothAdapterCache::reset()
+{
+    const QStringList adapters = m_adapters.keys();
+    for (const QString &adapter : adapters) {
+        removeAdapter(adapter);
+    }
+}
+
+void BluetoothAdapterCache::managedObjectsReceived(QDBusPendingCallWatcher *watcher)
+{
+    const QDBusPendingReply<ManagedObjects> reply = *watcher;
+    watcher->deleteLater();
+
+    if (reply.isValid()) {
+        const ManagedObjects objects = reply.value();
+        for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+            if (it.value().contains(QLatin1String(BLUEZ_ADAPTER_IFACE))) {
+                addAdapter(it.key().path(), it.value().value(QLatin1String(BLUEZ_ADAPTER_IFACE)));
+            }
+        }
+    } else {
+        qCDebug(PLASMA_NM) << "Failed to get BlueZ objects:" << reply.error().message();
+    }
+
+    // BlueZ not running is a valid state too, there are simply no adapters
+    if (!m_ready) {
+        m_ready = true;
+        Q_EMIT ready();
+    }
+}
+
+void BluetoothAdapterCache::interfacesAdded(const QDBusMessage &message)
+{
+    const QList<QVariant> arguments = message.arguments();
+    if (arguments.size() < 2) {
+        return;
+    }
+
+    const QString path = arguments.at(0).value<QDBusObjectPath>().path();
+    const NMVariantMapMap interfaces = qdbus_cast<NMVariantMapMap>(arguments.at(1));
+    if (interfaces.contains(QLatin1String(BLUEZ_ADAPTER_IFACE))) {
+        addAdapter(path, interfaces.value(QLatin1String(BLUEZ_ADAPTER_IFACE)));
+    }
+}
+
+void BluetoothAdapterCache::interfacesRemoved(const QDBusMessage &message)
+{
+    const QList<QVariant> arguments = message.arguments();
+    if (arguments.size() < 2) {
+        return;
+    }
+
+    const QString path = arguments.at(0).value<QDBusObjectPath>().path();
+    const QStringList interfaces = arguments.at(1).toStringList();
+    if (interfaces.contains(QLatin1String(BLUEZ_ADAPTER_IFACE))) {
+        removeAdapter(path);
+    }
+}
+
+void BluetoothAdapterCache::propertiesChanged(const QDBusMessage &message)
+{
+    const QList<QVariant> arguments = message.arguments();
+    if (arguments.size() < 2 || arguments.at(0).toString() != QLatin1String(BLUEZ_ADAPTER_IFACE)) {
+        return;
+    }
+
+    const QString path = message.path();
+    const QVariantMap properties = qdbus_cast<QVariantMap>(arguments.at(1));
+    const auto powered = properties.constFind(QLatin1String("Powered"));
+    if (powered == properties.constEnd()) {
+        return;
+    }
+
+    const bool enabled = powered.value().toBool();
+    const auto it = m_adapters.find(path);
+    if (it == m_adapters.end()) {
+        // Signal raced with GetManagedObjects/InterfacesAdded
+        addAdapter(path, properties);
+    } else if (it.value() != enabled) {
+        it.value() = enabled;
+        Q_EMIT poweredChanged(path, enabled);
+    }
+}
+
+void BluetoothAdapterCache::addAdapter(const QString &adapter, const QVariantMap &properties)
+{
+    const bool powered = properties.value(QLatin1String("Powered")).toBool();
+    const auto it = m_adapters.find(adapter);
+    if (it != m_adapters.end()) {
+        if (it.value() != powered) {
+            it.value() = powered;
+            Q_EMIT poweredChanged(adapter, powered);
+        }
+        return;
+    }
+
+    qCDebug(PLASMA_NM) << "Bluetooth adapter" << adapter << "added, powered:" << powered;
+    m_adapters.insert(adapter, powered);
+    Q_EMIT adapterAdded(adapter);
+}
+
+void BluetoothAdapterCache::removeAdapter(const QString &adapter)
+{
+    if (m_adapters.remove(adapter)) {
+        qCDebug(PLASMA_NM) << "Bluetooth adapter" << adapter << "removed";
+        Q_EMIT adapterRemoved(adapter);
+    }
+}
@@ -0,0 +1,92 @@
+/*
+    Copyright 2021  Wang Rui <wangrui@jingos.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLASMA_NM_BLUETOOTH_ADAPTER_CACHE_H
+#define PLASMA_NM_BLUETOOTH_ADAPTER_CACHE_H
+
+#include <QDBusConnection>
+#include <QMap>
+#include <QObject>
+
+class QDBusMessage;
+class QDBusPendingCallWatcher;
+class QDBusServiceWatcher;
+
+/**
+ * Keeps the power state of all BlueZ adapters up to date.
+ *
+ * The adapter list is fetched once with GetManagedObjects and then maintained
+ * from InterfacesAdded/InterfacesRemoved/PropertiesChanged, so changing the
+ * power state does not need any preceding round-trip to BlueZ.
+ */
+class Q_DECL_EXPORT BluetoothAdapterCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit BluetoothAdapterCache(QObject *parent = nullptr);
+    /**
+     * @bus - connection where the BlueZ service lives
+     * @service - name of the BlueZ service, "org.bluez" for the real one
+     */
+    BluetoothAdapterCache(const QDBusConnection &bus, const QString &service, QObject *parent = nullptr);
+    ~BluetoothAdapterCache() override;
+
+    /**
+     * True once the initial list of adapters has been received
+     */
+    bool isReady() const;
+
+    /**
+     * Returns d-bus paths of known adapters together with their power state
+     */
+    QMap<QString, bool> adapters() const;
+
+    /**
+     * Asynchronously changes the power state of given adapter, the cache is updated
+     * once BlueZ announces the change
+     */
+    void setPowered(const QString &adapter, bool powered);
+
+Q_SIGNALS:
+    void ready();
+    void adapterAdded(const QString &adapter);
+    void adapterRemoved(const QString &adapter);
+    void poweredChanged(const QString &adapter, bool powered);
+
+private Q_SLOTS:
+    void interfacesAdded(const QDBusMessage &message);
+    void interfacesRemoved(const QDBusMessage &message);
+    void propertiesChanged(const QDBusMessage &message);
+    void managedObjectsReceived(QDBusPendingCallWatcher *watcher);
+
+private:
+    void init();
+    void reset();
+    void addAdapter(const QString &adapter, const QVariantMap &properties);
+    void removeAdapter(const QString &adapter);
+
+    QDBusConnection m_bus;
+    QString m_service;
+    QDBusServiceWatcher *m_serviceWatcher;
+    QMap<QString, bool> m_adapters;
+    bool m_ready;
+};
+
+#endif // PLASMA_NM_BLUETOOTH_ADAPTER_CACHE_H
@@ -195,3 +195,26 @@ bool Configuration::showPasswordDialog()
     return true;
 }
 
+int Configuration::secretsCacheTimeout()
+{
+    KSharedConfigPtr config = KSharedConfig::openConfig(QLatin1String("plasma-nm"));
+    KConfigGroup grp(config, QLatin1String("General"));
+
+    if (grp.isValid()) {
+        return qMax(0, grp.readEntry(QLatin1String("SecretsCacheTimeout"), 0));
+    }
+
+    return 0;
+}
+
+bool Configuration::prefetchSecrets()
+{
+    KSharedConfigPtr config = KSharedConfig::openConfig(QLatin1String("plasma-nm"));
+    KConfigGroup grp(config, QLatin1String("General"));
+
+    if (grp.isValid()) {
+        return grp.readEntry(QLatin1String("PrefetchSecrets"), false);
+    }
+
+    return false;
+}
@@ -57,6 +57,18 @@ public:
     static void setHotspotConnectionPath(const QString &path);
 
     static bool showPasswordDialog();
+
+    /**
+     * Number of seconds the kded secret agent keeps secrets in memory after reading
+     * them from the wallet, 0 disables the cache
+     */
+    static int secretsCacheTimeout();
+
+    /**
+     * Whether kded should open the wallet right after login and load secrets of
+     * connections which are activated automatically into the secrets cache
+     */
+    static bool prefetchSecrets();
 };
 
 #endif // PLAMA_NM_CONFIGURATION_H
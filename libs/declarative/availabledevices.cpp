@@ -24,21 +24,9 @@
 
 AvailableDevices::AvailableDevices(QObject* parent)
     : QObject(parent)
-    , m_wiredDeviceAvailable(false)
-    , m_wirelessDeviceAvailable(false)
-    , m_modemDeviceAvailable(false)
-    , m_bluetoothDeviceAvailable(false)
 {
     for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
-        if (device->type() == NetworkManager::Device::Modem) {
-            m_modemDeviceAvailable = true;
-        } else if (device->type() == NetworkManager::Device::Wifi) {
-            m_wirelessDeviceAvailable = true;
-        } else if (device->type() == NetworkManager::Device::Ethernet) {
-            m_wiredDeviceAvailable = true;
-        } else if (device->type() == NetworkManager::Device::Bluetooth) {
-            m_bluetoothDeviceAvailable = true;
-        }
+        addDevice(device->uni(), device->type());
     }
 
     connect(NetworkManager::notifier(), &NetworkManager::Notifier::deviceAdded, this, &AvailableDevices::deviceAdded);
@@ -51,81 +39,87 @@ AvailableDevices::~AvailableDevices()
 
 bool AvailableDevices::isWiredDeviceAvailable() const
 {
-    return m_wiredDeviceAvailable;
+    return m_deviceCounts.value(NetworkManager::Device::Ethernet) > 0;
 }
 
 bool AvailableDevices::isWirelessDeviceAvailable() const
 {
-    return m_wirelessDeviceAvailable;
+    return m_deviceCounts.value(NetworkManager::Device::Wifi) > 0;
 }
 
 bool AvailableDevices::isModemDeviceAvailable() const
 {
-    return m_modemDeviceAvailable;
+    return m_deviceCounts.value(NetworkManager::Device::Modem) > 0;
 }
 
 bool AvailableDevices::isBluetoothDeviceAvailable() const
 {
-    return m_bluetoothDeviceAvailable;
+    return m_deviceCounts.value(NetworkManager::Device::Bluetooth) > 0;
 }
 
 void AvailableDevices::deviceAdded(const QString& dev)
 {
+    if (m_devices.contains(dev)) {
+        return;
+    }
+
     NetworkManager::Device::Ptr device = NetworkManager::findNetworkInterface(dev);
 
-    if (device) {
-        if (device->type() == NetworkManager::Device::Modem && !m_modemDeviceAvailable) {
-            m_modemDeviceAvailable = true;
-            Q_EMIT modemDeviceAvailableChanged(true);
-        } else if (device->type() == NetworkManager::Device::Wifi && !m_wirelessDeviceAvailable) {
-            m_wirelessDeviceAvailable = true;
-            Q_EMIT wirelessDeviceAvailableChanged(true);
-        } else if (device->type() == NetworkManager::Device::Ethernet && !m_wiredDeviceAvailable) {
-            m_wiredDeviceAvailable = true;
-            Q_EMIT wiredDeviceAvailableChanged(true);
-        } else if (device->type() == NetworkManager::Device::Bluetooth && !m_bluetoothDeviceAvailable) {
-            m_bluetoothDeviceAvailable = true;
-            Q_EMIT bluetoothDeviceAvailableChanged(true);
+    if (device && isTrackedType(device->type())) {
+        addDevice(dev, device->type());
+        if (m_deviceCounts.value(device->type()) == 1) {
+            emitAvailableChanged(device->type(), true);
         }
     }
 }
 
-void AvailableDevices::deviceRemoved()
+void AvailableDevices::deviceRemoved(const QString& dev)
 {
-    bool wired = false;
-    bool wireless = false;
-    bool modem = false;
-    bool bluetooth = false;
-
-    for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
-        if (device->type() == NetworkManager::Device::Modem) {
-            modem = true;
-        } else if (device->type() == NetworkManager::Device::Wifi) {
-            wireless = true;
-        } else if (device->type() == NetworkManager::Device::Ethernet) {
-            wired = true;
-        } else if (device->type() == NetworkManager::Device::Bluetooth) {
-            bluetooth = true;
-        }
+    auto it = m_devices.find(dev);
+    if (it == m_devices.end()) {
+        return;
     }
 
-    if (!wired && m_wiredDeviceAvailable) {
-        m_wiredDeviceAvailable = false;
-        Q_EMIT wiredDeviceAvailableChanged(false);
-    }
+    const NetworkManager::Device::Type type = it.value();
+    m_devices.erase(it);
 
-    if (!wireless && m_wirelessDeviceAvailable) {
-        m_wirelessDeviceAvailable = false;
-        Q_EMIT wirelessDeviceAvailableChanged(false);
+    if (--m_deviceCounts[type] == 0) {
+        emitAvailableChanged(type, false);
     }
+}
 
-    if (!modem && m_modemDeviceAvailable) {
-        m_modemDeviceAvailable = false;
-        Q_EMIT modemDeviceAvailableChanged(false);
+bool AvailableDevices::isTrackedType(NetworkManager::Device::Type type)
+{
+    return type == NetworkManager::Device::Ethernet || type == NetworkManager::Device::Wifi
+        || type == NetworkManager::Device::Modem || type == NetworkManager::Device::Bluetooth;
+}
+
+void AvailableDevices::addDevice(const QString &uni, NetworkManager::Device::Type type)
+{
+    if (!isTrackedType(type) || m_devices.contains(uni)) {
+        return;
     }
 
-    if (!bluetooth && m_bluetoothDeviceAvailable) {
-        m_bluetoothDeviceAvailable = false;
-        Q_EMIT bluetoothDeviceAvailableChanged(false);
+    m_devices.insert(uni, type);
+    ++m_deviceCounts[type];
+}
+
+void AvailableDevices::emitAvailableChanged(NetworkManager::Device::Type type, bool available)
+{
+    switch (type) {
+    case NetworkManager::Device::Ethernet:
+        Q_EMIT wiredDeviceAvailableChanged(available);
+        break;
+    case NetworkManager::Device::Wifi:
+        Q_EMIT wirelessDeviceAvailableChanged(available);
+        break;
+    case NetworkManager::Device::Modem:
+        Q_EMIT modemDeviceAvailableChanged(available);
+        break;
+    case NetworkManager::Device::Bluetooth:
+        Q_EMIT bluetoothDeviceAvailableChanged(available);
+        break;
+    default:
+        break;
     }
 }
@@ -21,6 +21,7 @@
 #ifndef PLASMA_NM_AVAILABLE_DEVICES_H
 #define PLASMA_NM_AVAILABLE_DEVICES_H
 
+#include <QHash>
 #include <QObject>
 
 #include <NetworkManagerQt/Device>
@@ -58,7 +59,7 @@ public Q_SLOTS:
 
 private Q_SLOTS:
     void deviceAdded(const QString& dev);
-    void deviceRemoved();
+    void deviceRemoved(const QString& dev);
 
 Q_SIGNALS:
     void wiredDeviceAvailableChanged(bool available);
@@ -67,10 +68,13 @@ Q_SIGNALS:
     void bluetoothDeviceAvailableChanged(bool available);
 
 private:
-    bool m_wiredDeviceAvailable;
-    bool m_wirelessDeviceAvailable;
-    bool m_modemDeviceAvailable;
-    bool m_bluetoothDeviceAvailable;
+    static bool isTrackedType(NetworkManager::Device::Type type);
+    void addDevice(const QString &uni, NetworkManager::Device::Type type);
+    void emitAvailableChanged(NetworkManager::Device::Type type, bool available);
+
+    // Type of every present device we care about, so removals don't need to look at other devices
+    QHash<QString, NetworkManager::Device::Type> m_devices;
+    QHash<int, int> m_deviceCounts;
 };
 
 #endif // PLASMA_NM_AVAILABLE_DEVICES_H
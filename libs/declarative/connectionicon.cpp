@@ -48,6 +48,11 @@ ConnectionIcon::ConnectionIcon(QObject* parent)
     , m_modemNetwork(nullptr)
 #endif
 {
+    m_recomputeTimer = new QTimer(this);
+    m_recomputeTimer->setSingleShot(true);
+    m_recomputeTimer->setInterval(0);
+    connect(m_recomputeTimer, &QTimer::timeout, this, &ConnectionIcon::recompute);
+
     connect(NetworkManager::notifier(), &NetworkManager::Notifier::primaryConnectionChanged, this, &ConnectionIcon::primaryConnectionChanged);
     connect(NetworkManager::notifier(), &NetworkManager::Notifier::activatingConnectionChanged, this, &ConnectionIcon::activatingConnectionChanged);
     connect(NetworkManager::notifier(), &NetworkManager::Notifier::activeConnectionAdded, this, &ConnectionIcon::activeConnectionAdded);
@@ -124,7 +129,7 @@ QString ConnectionIcon::connectionTooltipIcon() const
 void ConnectionIcon::activatingConnectionChanged(const QString& connection)
 {
     Q_UNUSED(connection);
-    setIcons();
+    scheduleRecompute(IconsDirty);
 }
 
 void ConnectionIcon::addActiveConnection(const QString &activeConnection)
@@ -146,24 +151,24 @@ void ConnectionIcon::addActiveConnection(const QString &activeConnection)
 void ConnectionIcon::activeConnectionAdded(const QString &activeConnection)
 {
     addActiveConnection(activeConnection);
-    setStates();
+    scheduleRecompute(StatesDirty);
 }
 
 void ConnectionIcon::activeConnectionStateChanged(NetworkManager::ActiveConnection::State state)
 {
     Q_UNUSED(state);
-    setStates();
+    scheduleRecompute(StatesDirty);
 }
 
 void ConnectionIcon::activeConnectionDestroyed()
 {
-    setStates();
+    scheduleRecompute(StatesDirty);
 }
 
 void ConnectionIcon::carrierChanged(bool carrier)
 {
     Q_UNUSED(carrier);
-    setIcons();
+    scheduleRecompute(IconsDirty);
 }
 
 void ConnectionIcon::connectivityChanged(NetworkManager::Connectivity conn)
@@ -195,7 +200,7 @@ void ConnectionIcon::deviceRemoved(const QString& device)
     Q_UNUSED(device);
 
     if (NetworkManager::status() == NetworkManager::Disconnected) {
-        setDisconnectedIcon();
+        scheduleRecompute(DisconnectedIconDirty);
     }
 }
 
@@ -228,14 +233,14 @@ void ConnectionIcon::networkingEnabledChanged(bool enabled)
 void ConnectionIcon::primaryConnectionChanged(const QString& connection)
 {
     if (!connection.isEmpty()) {
-        setIcons();
+        scheduleRecompute(IconsDirty);
     }
 }
 
 void ConnectionIcon::statusChanged(NetworkManager::Status status)
 {
     if (status == NetworkManager::Disconnected) {
-        setDisconnectedIcon();
+        scheduleRecompute(DisconnectedIconDirty);
     }
 }
 
@@ -243,27 +248,59 @@ void ConnectionIcon::vpnConnectionStateChanged(NetworkManager::VpnConnection::St
 {
     Q_UNUSED(state);
     Q_UNUSED(reason);
-    setStates();
-    setIcons();
+    scheduleRecompute(StatesDirty);
+    scheduleRecompute(IconsDirty);
 }
 
 void ConnectionIcon::wirelessEnabledChanged(bool enabled)
 {
     Q_UNUSED(enabled);
-    setIcons();
+    scheduleRecompute(IconsDirty);
 }
 
 void ConnectionIcon::wwanEnabledChanged(bool enabled)
 {
     Q_UNUSED(enabled);
-    setIcons();
-
+    scheduleRecompute(IconsDirty);
 }
 
 void ConnectionIcon::wirelessNetworkAppeared(const QString& network)
 {
     Q_UNUSED(network);
-    setIcons();
+    scheduleRecompute(IconsDirty);
+}
+
+void ConnectionIcon::scheduleRecompute(DirtyFlag flag)
+{
+    m_dirty |= flag;
+    if (!m_recomputeTimer->isActive()) {
+        m_recomputeTimer->start();
+    }
+}
+
+void ConnectionIcon::recompute()
+{
+    const int dirty = m_dirty;
+    m_dirty = 0;
+
+    if (!dirty) {
+        return;
+    }
+
+    ++m_recomputeCount;
+
+    if (dirty & StatesDirty) {
+        setStates();
+    }
+
+    if (dirty & IconsDirty) {
+        setIcons();
+    }
+
+    // Status might have changed again in the meantime
+    if ((dirty & DisconnectedIconDirty) && NetworkManager::status() == NetworkManager::Disconnected) {
+        setDisconnectedIcon();
+    }
 }
 
 void ConnectionIcon::setStates()
@@ -302,17 +339,30 @@ void ConnectionIcon::setStates()
 void ConnectionIcon::setIcons()
 {
     m_signal = 0;
+
+    // Keep the current subscriptions, they are dropped below only when the
+    // network or modem we show the icon for changed
 #if WITH_MODEMMANAGER_SUPPORT
-    if (m_modemNetwork) {
-        disconnect(m_modemNetwork.data(), nullptr, this, nullptr);
-        m_modemNetwork.clear();
+    const ModemManager::Modem::Ptr previousModemNetwork = m_modemNetwork;
+    m_modemNetwork.clear();
+#endif
+    const NetworkManager::WirelessNetwork::Ptr previousWirelessNetwork = m_wirelessNetwork;
+    m_wirelessNetwork.clear();
+
+    updateIcons();
+
+#if WITH_MODEMMANAGER_SUPPORT
+    if (previousModemNetwork && previousModemNetwork != m_modemNetwork) {
+        disconnect(previousModemNetwork.data(), nullptr, this, nullptr);
     }
 #endif
-    if (m_wirelessNetwork) {
-        disconnect(m_wirelessNetwork.data(), nullptr, this, nullptr);
-        m_wirelessNetwork.clear();
+    if (previousWirelessNetwork && previousWirelessNetwork != m_wirelessNetwork) {
+        disconnect(previousWirelessNetwork.data(), nullptr, this, nullptr);
     }
+}
 
+void ConnectionIcon::updateIcons()
+{
     NetworkManager::ActiveConnection::Ptr connection = NetworkManager::activatingConnection();
 
     // Set icon based on the current primary connection if the activating connection is virtual
@@ -494,7 +544,7 @@ void ConnectionIcon::setModemIcon(const NetworkManager::Device::Ptr & device)
     if (m_modemNetwork) {
         connect(m_modemNetwork.data(), &ModemManager::Modem::signalQualityChanged, this, &ConnectionIcon::modemSignalChanged, Qt::UniqueConnection);
         connect(m_modemNetwork.data(), &ModemManager::Modem::accessTechnologiesChanged, this, &ConnectionIcon::setIconForModem, Qt::UniqueConnection);
-        connect(m_modemNetwork.data(), &ModemManager::Modem::destroyed, this, &ConnectionIcon::modemNetworkRemoved);
+        connect(m_modemNetwork.data(), &ModemManager::Modem::destroyed, this, &ConnectionIcon::modemNetworkRemoved, Qt::UniqueConnection);
 
         m_signal = m_modemNetwork->signalQuality().signal;
         setIconForModem();
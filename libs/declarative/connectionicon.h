@@ -21,6 +21,8 @@
 #ifndef PLASMA_NM_CONNECTION_ICON_H
 #define PLASMA_NM_CONNECTION_ICON_H
 
+#include <QTimer>
+
 #include <NetworkManagerQt/Manager>
 #include <NetworkManagerQt/ActiveConnection>
 #include <NetworkManagerQt/VpnConnection>
@@ -29,7 +31,7 @@
 #include <ModemManagerQt/modem.h>
 #endif
 
-class ConnectionIcon : public QObject
+class Q_DECL_EXPORT ConnectionIcon : public QObject
 {
 Q_PROPERTY(bool connecting READ connecting NOTIFY connectingChanged)
 Q_PROPERTY(QString connectionIcon READ connectionIcon NOTIFY connectionIconChanged)
@@ -47,6 +49,11 @@ public:
 
     bool needsPortal() const { return m_needsPortal; }
 
+    /**
+     * Returns how many times states and icons were recomputed, used by tests
+     */
+    int recomputeCount() const { return m_recomputeCount; }
+
 private Q_SLOTS:
     void activatingConnectionChanged(const QString & connection);
     void activeConnectionAdded(const QString & activeConnection);
@@ -69,6 +76,7 @@ private Q_SLOTS:
     void wirelessEnabledChanged(bool enabled);
     void wirelessNetworkAppeared(const QString &network);
     void wwanEnabledChanged(bool enabled);
+    void recompute();
 Q_SIGNALS:
     void connectingChanged(bool connecting);
     void connectionIconChanged(const QString & icon);
@@ -76,6 +84,17 @@ Q_SIGNALS:
     void needsPortalChanged(bool needsPortal);
 
 private:
+    enum DirtyFlag {
+        StatesDirty = 1 << 0,
+        IconsDirty = 1 << 1,
+        DisconnectedIconDirty = 1 << 2
+    };
+
+    /**
+     * Marks given part as outdated, everything marked during one event loop
+     * iteration is recomputed only once
+     */
+    void scheduleRecompute(DirtyFlag flag);
     void addActiveConnection(const QString & activeConnection);
     void setConnecting(bool connecting);
     void setConnectionIcon(const QString & icon);
@@ -91,9 +110,13 @@ private:
     QString m_connectionIcon;
     QString m_connectionTooltipIcon;
     bool m_needsPortal = false;
+    int m_dirty = 0;
+    int m_recomputeCount = 0;
+    QTimer *m_recomputeTimer = nullptr;
 
     void setDisconnectedIcon();
     void setIcons();
+    void updateIcons();
     void setStates();
     void setWirelessIcon(const NetworkManager::Device::Ptr & device, const QString & ssid);
 #if WITH_MODEMMANAGER_SUPPORT
@@ -29,6 +29,8 @@
 
 #include <KLocalizedString>
 
+#include <algorithm>
+
 NetworkStatus::SortedConnectionType NetworkStatus::connectionTypeToSortedType(NetworkManager::ConnectionSettings::ConnectionType type)
 {
     switch (type) {
@@ -74,7 +76,7 @@ NetworkStatus::SortedConnectionType NetworkStatus::connectionTypeToSortedType(Ne
 NetworkStatus::NetworkStatus(QObject* parent)
     : QObject(parent)
 {
-    connect(NetworkManager::notifier(), &NetworkManager::Notifier::connectivityChanged, this,  &NetworkStatus::changeActiveConnections);
+    connect(NetworkManager::notifier(), &NetworkManager::Notifier::connectivityChanged, this,  &NetworkStatus::connectivityChanged);
     connect(NetworkManager::notifier(), &NetworkManager::Notifier::statusChanged, this, &NetworkStatus::statusChanged);
     connect(NetworkManager::notifier(), &NetworkManager::Notifier::activeConnectionsChanged, this, QOverload<>::of(&NetworkStatus::activeConnectionsChanged));
 
@@ -98,13 +100,70 @@ QString NetworkStatus::networkStatus() const
 
 void NetworkStatus::activeConnectionsChanged()
 {
+    QStringList activePaths;
+    bool changed = false;
+
     for (const NetworkManager::ActiveConnection::Ptr & active : NetworkManager::activeConnections()) {
+        const QString path = active->path();
+        activePaths << path;
+
+        if (m_lines.contains(path)) {
+            continue;
+        }
+
         connect(active.data(), &NetworkManager::ActiveConnection::default4Changed, this, &NetworkStatus::defaultChanged, Qt::UniqueConnection);
         connect(active.data(), &NetworkManager::ActiveConnection::default6Changed, this, &NetworkStatus::defaultChanged, Qt::UniqueConnection);
-        connect(active.data(), &NetworkManager::ActiveConnection::stateChanged, this, &NetworkStatus::changeActiveConnections);
+        connect(active.data(), &NetworkManager::ActiveConnection::stateChanged, this, &NetworkStatus::activeConnectionStateChanged, Qt::UniqueConnection);
+
+        ActiveConnectionLine &line = m_lines[path];
+        line.active = active;
+        NetworkManager::Connection::Ptr connection = active->connection();
+        if (connection) {
+            line.connectionUpdated = connect(connection.data(), &NetworkManager::Connection::updated, this, [this, path] () {
+                updateLine(path);
+            });
+        }
+        updateLine(line);
+        changed = true;
+    }
+
+    auto it = m_lines.begin();
+    while (it != m_lines.end()) {
+        if (!activePaths.contains(it.key())) {
+            disconnect(it->active.data(), nullptr, this, nullptr);
+            disconnect(it->connectionUpdated);
+            it = m_lines.erase(it);
+            changed = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (changed || activePaths != m_activePaths) {
+        m_activePaths = activePaths;
+        changeActiveConnections();
+    }
+}
+
+void NetworkStatus::activeConnectionStateChanged()
+{
+    NetworkManager::ActiveConnection *active = qobject_cast<NetworkManager::ActiveConnection*>(sender());
+    if (active) {
+        updateLine(active->path());
+    }
+}
+
+void NetworkStatus::connectivityChanged()
+{
+    // Connectivity is part of the status of every connected line
+    bool changed = false;
+    for (ActiveConnectionLine &line : m_lines) {
+        changed |= updateLine(line);
     }
 
-    changeActiveConnections();
+    if (changed) {
+        changeActiveConnections();
+    }
 }
 
 void NetworkStatus::defaultChanged()
@@ -156,6 +215,90 @@ void NetworkStatus::statusChanged(NetworkManager::Status status)
     }
 }
 
+void NetworkStatus::updateLine(const QString &activePath)
+{
+    auto it = m_lines.find(activePath);
+    if (it != m_lines.end() && updateLine(it.value())) {
+        changeActiveConnections();
+    }
+}
+
+bool NetworkStatus::updateLine(ActiveConnectionLine &line)
+{
+    const NetworkManager::ActiveConnection::Ptr &active = line.active;
+    QString text;
+
+    if (!active->devices().isEmpty() && UiUtils::isConnectionTypeSupported(active->type())) {
+
+        NetworkManager::Device::Ptr device = NetworkManager::findNetworkInterface(active->devices().first());
+        if (device && ((device->type() != NetworkManager::Device::Generic && device->type() <= NetworkManager::Device::Team)
+                       || device->type() == 29)) {  // TODO: Change to WireGuard enum value when it is added
+            bool connecting = false;
+            bool connected = false;
+            QString conType;
+            QString status;
+            NetworkManager::VpnConnection::Ptr vpnConnection;
+
+            if (active->vpn()) {
+                conType = i18n("VPN");
+                vpnConnection = active.objectCast<NetworkManager::VpnConnection>();
+            } else {
+                conType = UiUtils::interfaceTypeLabel(device->type(), device);
+            }
+
+            if (vpnConnection && active->vpn()) {
+                if (vpnConnection->state() >= NetworkManager::VpnConnection::Prepare &&
+                    vpnConnection->state() <= NetworkManager::VpnConnection::GettingIpConfig) {
+                    connecting = true;
+                } else if (vpnConnection->state() == NetworkManager::VpnConnection::Activated) {
+                    connected = true;
+                }
+            } else {
+                if (active->state() == NetworkManager::ActiveConnection::Activated) {
+                    connected = true;
+                } else if (active->state() == NetworkManager::ActiveConnection::Activating) {
+                    connecting = true;
+                }
+            }
+
+            if (active->type() == NetworkManager::ConnectionSettings::ConnectionType::WireGuard) {
+                conType = i18n("WireGuard");
+                connected = true;
+            }
+
+            NetworkManager::Connection::Ptr connection = active->connection();
+            if (connecting) {
+                status = i18n("Connecting to %1", connection->name());
+            } else if (connected) {
+                switch (NetworkManager::connectivity()) {
+                    case NetworkManager::NoConnectivity:
+                        status = i18n("Connected to %1 (no connectivity)", connection->name());
+                        break;
+                    case NetworkManager::Limited:
+                        status = i18n("Connected to %1 (limited connectivity)", connection->name());
+                        break;
+                    case NetworkManager::Portal:
+                        status = i18n("Connected to %1 (log in required)", connection->name());
+                        break;
+                    default:
+                        status = i18n("Connected to %1", connection->name());
+                        break;
+                }
+            }
+
+            text = QStringLiteral("%1: %2").arg(conType, status);
+        }
+    }
+
+    line.sortedType = connectionTypeToSortedType(active->type());
+    if (line.text == text) {
+        return false;
+    }
+
+    line.text = text;
+    return true;
+}
+
 void NetworkStatus::changeActiveConnections()
 {
     if (NetworkManager::status() != NetworkManager::Connected &&
@@ -164,82 +307,25 @@ void NetworkStatus::changeActiveConnections()
         return;
     }
 
-    QString activeConnections;
-    const QString format = QStringLiteral("%1: %2");
+    QList<const ActiveConnectionLine*> lines;
+    for (const QString &path : qAsConst(m_activePaths)) {
+        auto it = m_lines.constFind(path);
+        if (it != m_lines.constEnd() && !it->text.isEmpty()) {
+            lines << &it.value();
+        }
+    }
 
-    QList<NetworkManager::ActiveConnection::Ptr> activeConnectionList = NetworkManager::activeConnections();
-    std::sort(activeConnectionList.begin(), activeConnectionList.end(), [] (const NetworkManager::ActiveConnection::Ptr &left, const NetworkManager::ActiveConnection::Ptr &right)
+    std::stable_sort(lines.begin(), lines.end(), [] (const ActiveConnectionLine *left, const ActiveConnectionLine *right)
     {
-        return NetworkStatus::connectionTypeToSortedType(left->type()) < NetworkStatus::connectionTypeToSortedType(right->type());
+        return left->sortedType < right->sortedType;
     });
 
-    for (const NetworkManager::ActiveConnection::Ptr &active : activeConnectionList) {
-        if (!active->devices().isEmpty() && UiUtils::isConnectionTypeSupported(active->type())) {
-
-            NetworkManager::Device::Ptr device = NetworkManager::findNetworkInterface(active->devices().first());
-            if (device && ((device->type() != NetworkManager::Device::Generic && device->type() <= NetworkManager::Device::Team)
-                           || device->type() == 29)) {  // TODO: Change to WireGuard enum value when it is added
-                bool connecting = false;
-                bool connected = false;
-                QString conType;
-                QString status;
-                NetworkManager::VpnConnection::Ptr vpnConnection;
-
-                if (active->vpn()) {
-                    conType = i18n("VPN");
-                    vpnConnection = active.objectCast<NetworkManager::VpnConnection>();
-                } else {
-                    conType = UiUtils::interfaceTypeLabel(device->type(), device);
-                }
-
-                if (vpnConnection && active->vpn()) {
-                    if (vpnConnection->state() >= NetworkManager::VpnConnection::Prepare &&
-                        vpnConnection->state() <= NetworkManager::VpnConnection::GettingIpConfig) {
-                        connecting = true;
-                    } else if (vpnConnection->state() == NetworkManager::VpnConnection::Activated) {
-                        connected = true;
-                    }
-                } else {
-                    if (active->state() == NetworkManager::ActiveConnection::Activated) {
-                        connected = true;
-                    } else if (active->state() == NetworkManager::ActiveConnection::Activating) {
-                        connecting = true;
-                    }
-                }
-
-                if (active->type() == NetworkManager::ConnectionSettings::ConnectionType::WireGuard) {
-                    conType = i18n("WireGuard");
-                    connected = true;
-                }
-
-                NetworkManager::Connection::Ptr connection = active->connection();
-                if (connecting) {
-                    status = i18n("Connecting to %1", connection->name());
-                } else if (connected) {
-                    switch (NetworkManager::connectivity()) {
-                        case NetworkManager::NoConnectivity:
-                            status = i18n("Connected to %1 (no connectivity)", connection->name());
-                            break;
-                        case NetworkManager::Limited:
-                            status = i18n("Connected to %1 (limited connectivity)", connection->name());
-                            break;
-                        case NetworkManager::Portal:
-                            status = i18n("Connected to %1 (log in required)", connection->name());
-                            break;
-                        default:
-                            status = i18n("Connected to %1", connection->name());
-                            break;
-                    }
-                }
-
-                if (!activeConnections.isEmpty()) {
-                    activeConnections += '\n';
-                }
-                activeConnections += format.arg(conType, status);
-
-                connect(connection.data(), &NetworkManager::Connection::updated, this, &NetworkStatus::changeActiveConnections, Qt::UniqueConnection);
-            }
+    QString activeConnections;
+    for (const ActiveConnectionLine *line : qAsConst(lines)) {
+        if (!activeConnections.isEmpty()) {
+            activeConnections += '\n';
         }
+        activeConnections += line->text;
     }
 
     if (m_activeConnections != activeConnections) {
@@ -21,8 +21,10 @@
 #ifndef PLASMA_NM_NETWORK_STATUS_H
 #define PLASMA_NM_NETWORK_STATUS_H
 
+#include <QHash>
 #include <QObject>
 
+#include <NetworkManagerQt/ActiveConnection>
 #include <NetworkManagerQt/Manager>
 
 class NetworkStatus : public QObject
@@ -61,17 +63,36 @@ public:
 
 private Q_SLOTS:
     void activeConnectionsChanged();
+    void activeConnectionStateChanged();
+    void connectivityChanged();
     void defaultChanged();
     void statusChanged(NetworkManager::Status status);
-    void changeActiveConnections();
 
 Q_SIGNALS:
     void activeConnectionsChanged(const QString & activeConnections);
     void networkStatusChanged(const QString & status);
 
 private:
+    // Cached line of the summary for one active connection
+    struct ActiveConnectionLine {
+        NetworkManager::ActiveConnection::Ptr active;
+        QMetaObject::Connection connectionUpdated;
+        SortedConnectionType sortedType = Other;
+        QString text;
+    };
+
+    /**
+     * Recomputes the line of given active connection, returns true when it changed
+     */
+    bool updateLine(ActiveConnectionLine &line);
+    void updateLine(const QString &activePath);
+    void changeActiveConnections();
+
     QString m_activeConnections;
     QString m_networkStatus;
+    QHash<QString, ActiveConnectionLine> m_lines;
+    // Active connection paths in the order NetworkManager lists them
+    QStringList m_activePaths;
 
     QString checkUnknownReason() const;
 };
@@ -48,8 +48,11 @@
 #include <NetworkManagerQt/CdmaSetting>
 #include <NetworkManagerQt/GenericTypes>
 #include <NetworkManagerQt/GsmSetting>
+#include <NetworkManagerQt/Ipv4Setting>
+#include <NetworkManagerQt/Ipv6Setting>
 #include <NetworkManagerQt/PppoeSetting>
 #include <NetworkManagerQt/Settings>
+#include <NetworkManagerQt/VlanSetting>
 #include <NetworkManagerQt/VpnSetting>
 #include <NetworkManagerQt/Utils>
 #include <NetworkManagerQt/WirelessSetting>
@@ -61,11 +64,15 @@
 #include <KServiceTypeTrader>
 #include <KUser>
 
+#include <QEvent>
+#include <QVBoxLayout>
+
 ConnectionEditorBase::ConnectionEditorBase(const NetworkManager::ConnectionSettings::Ptr &connection,
                                            QWidget *parent, Qt::WindowFlags f)
     : QWidget(parent, f)
     , m_initialized(false)
     , m_valid(false)
+    , m_lazyTabs(false)
     , m_pendingReplies(0)
     , m_connection(connection)
 {
@@ -91,8 +98,12 @@ void ConnectionEditorBase::setConnection(const NetworkManager::ConnectionSetting
     // Reset UI setting widgets
     delete m_connectionWidget;
     m_connectionWidget = nullptr;
-    qDeleteAll(m_settingWidgets);
+    for (const SettingTab &tab : qAsConst(m_settingTabs)) {
+        delete tab.page;
+    }
+    m_settingTabs.clear();
     m_settingWidgets.clear();
+    m_loadedSecrets.clear();
 
     initialize();
 }
@@ -100,8 +111,23 @@ void ConnectionEditorBase::setConnection(const NetworkManager::ConnectionSetting
 NMVariantMapMap ConnectionEditorBase::setting() const
 {
     NMVariantMapMap settings = m_connectionWidget->setting();
+    NMVariantMapMap originalSettings;
+
+    for (const SettingTab &tab : m_settingTabs) {
+        SettingWidget *widget = tab.widget;
+        if (!widget) {
+            // The user never saw this tab, keep what the connection had
+            if (originalSettings.isEmpty()) {
+                originalSettings = m_connection->toMap();
+            }
+            for (const QString &type : tab.types) {
+                if (originalSettings.contains(type)) {
+                    settings.insert(type, originalSettings.value(type));
+                }
+            }
+            continue;
+        }
 
-    for (SettingWidget *widget : m_settingWidgets) {
         const QString type = widget->type();
         if (type != NetworkManager::Setting::typeAsString(NetworkManager::Setting::Security8021x) &&
                 type != NetworkManager::Setting::typeAsString(NetworkManager::Setting::WirelessSecurity)) {
@@ -185,13 +211,178 @@ void ConnectionEditorBase::addConnectionWidget(ConnectionWidget *widget, const Q
     addWidget(widget, text);
 }
 
-void ConnectionEditorBase::addSettingWidget(SettingWidget *widget, const QString &text)
+void ConnectionEditorBase::addSettingWidget(const QString &text, const QList<NetworkManager::Setting::SettingType> &types, const std::function<SettingWidget *()> &factory)
 {
+    SettingTab tab;
+    tab.page = new QWidget(this);
+    tab.factory = factory;
+    tab.widget = nullptr;
+    for (NetworkManager::Setting::SettingType type : types) {
+        tab.types << NetworkManager::Setting::typeAsString(type);
+    }
+
+    QVBoxLayout *layout = new QVBoxLayout(tab.page);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    addWidget(tab.page, text);
+    m_settingTabs << tab;
+
+    if (m_lazyTabs) {
+        tab.page->installEventFilter(this);
+    } else {
+        createSettingWidget(m_settingTabs.last());
+    }
+}
+
+SettingWidget *ConnectionEditorBase::createSettingWidget(SettingTab &tab)
+{
+    if (tab.widget || !tab.factory) {
+        return tab.widget;
+    }
+
+    tab.page->removeEventFilter(this);
+    SettingWidget *widget = tab.factory();
+    tab.factory = nullptr;
+    if (!widget) {
+        return nullptr;
+    }
+
+    tab.widget = widget;
+    tab.page->layout()->addWidget(widget);
     m_settingWidgets << widget;
 
     connect(widget, &SettingWidget::settingChanged, this, &ConnectionEditorBase::settingChanged);
+    connect(widget, &SettingWidget::validChanged, this, &ConnectionEditorBase::validChanged);
 
-    addWidget(widget, text);
+    // Secrets could have arrived before the widget existed
+    for (const QString &settingName : qAsConst(m_loadedSecrets)) {
+        if (secretsBelongTo(settingName, widget->type())) {
+            widget->loadSecrets(m_connection->setting(NetworkManager::Setting::typeFromString(settingName)));
+        }
+    }
+
+    if (m_lazyTabs) {
+        KAcceleratorManager::manage(tab.page);
+        if (m_initialized) {
+            validChanged(widget->isValid());
+        }
+    }
+
+    return widget;
+}
+
+SettingWidget *ConnectionEditorBase::settingWidget(NetworkManager::Setting::SettingType type)
+{
+    const QString typeName = NetworkManager::Setting::typeAsString(type);
+    for (SettingTab &tab : m_settingTabs) {
+        if (tab.types.first() == typeName) {
+            return createSettingWidget(tab);
+        }
+    }
+    return nullptr;
+}
+
+bool ConnectionEditorBase::tabsValid() const
+{
+    for (SettingWidget *widget : m_settingWidgets) {
+        if (!widget->isValid()) {
+            return false;
+        }
+    }
+
+    for (const SettingTab &tab : m_settingTabs) {
+        if (!tab.widget && tab.factory && !settingIsValid(m_connection->setting(NetworkManager::Setting::typeFromString(tab.types.first())))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ConnectionEditorBase::settingIsValid(const NetworkManager::Setting::Ptr &setting)
+{
+    // Mirrors the checks of the setting widgets which can be done without the secrets
+    if (!setting) {
+        return true;
+    }
+
+    switch (setting->type()) {
+    case NetworkManager::Setting::Wireless:
+        return !setting.staticCast<NetworkManager::WirelessSetting>()->ssid().isEmpty();
+    case NetworkManager::Setting::Ipv4: {
+        NetworkManager::Ipv4Setting::Ptr ipv4Setting = setting.staticCast<NetworkManager::Ipv4Setting>();
+        if (ipv4Setting->method() != NetworkManager::Ipv4Setting::Manual) {
+            return true;
+        }
+        const QList<NetworkManager::IpAddress> addresses = ipv4Setting->addresses();
+        if (addresses.isEmpty()) {
+            return false;
+        }
+        for (const NetworkManager::IpAddress &address : addresses) {
+            if (address.ip().isNull() || address.netmask().isNull()) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case NetworkManager::Setting::Ipv6: {
+        NetworkManager::Ipv6Setting::Ptr ipv6Setting = setting.staticCast<NetworkManager::Ipv6Setting>();
+        if (ipv6Setting->method() != NetworkManager::Ipv6Setting::Manual) {
+            return true;
+        }
+        const QList<NetworkManager::IpAddress> addresses = ipv6Setting->addresses();
+        if (addresses.isEmpty()) {
+            return false;
+        }
+        for (const NetworkManager::IpAddress &address : addresses) {
+            if (address.ip().isNull()) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case NetworkManager::Setting::Vlan: {
+        NetworkManager::VlanSetting::Ptr vlanSetting = setting.staticCast<NetworkManager::VlanSetting>();
+        return !vlanSetting->parent().isEmpty() || !vlanSetting->interfaceName().isEmpty();
+    }
+    case NetworkManager::Setting::Pppoe: {
+        NetworkManager::PppoeSetting::Ptr pppoeSetting = setting.staticCast<NetworkManager::PppoeSetting>();
+        return pppoeSetting->passwordFlags().testFlag(NetworkManager::Setting::NotRequired) || !pppoeSetting->username().isEmpty();
+    }
+    case NetworkManager::Setting::Gsm: {
+        NetworkManager::GsmSetting::Ptr gsmSetting = setting.staticCast<NetworkManager::GsmSetting>();
+        return gsmSetting->passwordFlags().testFlag(NetworkManager::Setting::NotRequired) || !gsmSetting->username().isEmpty();
+    }
+    case NetworkManager::Setting::Cdma: {
+        NetworkManager::CdmaSetting::Ptr cdmaSetting = setting.staticCast<NetworkManager::CdmaSetting>();
+        return cdmaSetting->passwordFlags().testFlag(NetworkManager::Setting::NotRequired) || !cdmaSetting->username().isEmpty();
+    }
+    case NetworkManager::Setting::Vpn:
+        return !setting.staticCast<NetworkManager::VpnSetting>()->serviceType().isEmpty();
+    default:
+        return true;
+    }
+}
+
+bool ConnectionEditorBase::secretsBelongTo(const QString &settingName, const QString &type)
+{
+    return type == settingName ||
+           (settingName == NetworkManager::Setting::typeAsString(NetworkManager::Setting::Security8021x) &&
+            type == NetworkManager::Setting::typeAsString(NetworkManager::Setting::WirelessSecurity));
+}
+
+bool ConnectionEditorBase::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Show) {
+        for (SettingTab &tab : m_settingTabs) {
+            if (tab.page == watched) {
+                createSettingWidget(tab);
+                break;
+            }
+        }
+    }
+
+    return QWidget::eventFilter(watched, event);
 }
 
 void ConnectionEditorBase::initialize()
@@ -207,92 +398,124 @@ void ConnectionEditorBase::initialize()
     ConnectionWidget *connectionWidget = new ConnectionWidget(m_connection);
     addConnectionWidget(connectionWidget, i18nc("General", "General configuration"));
 
-    // Add the rest of widgets
+    // Add the rest of widgets, for existing connections they are created only when shown
+    m_lazyTabs = !emptyConnection;
     QString serviceType;
     if (type == NetworkManager::ConnectionSettings::Wired) {
-        WiredConnectionWidget *wiredWidget = new WiredConnectionWidget(m_connection->setting(NetworkManager::Setting::Wired), this);
-        addSettingWidget(wiredWidget, i18n("Wired"));
-        WiredSecurity *wiredSecurity = new WiredSecurity(m_connection->setting(NetworkManager::Setting::Security8021x).staticCast<NetworkManager::Security8021xSetting>(), this);
-        addSettingWidget(wiredSecurity, i18n("802.1x Security"));
+        addSettingWidget(i18n("Wired"), {NetworkManager::Setting::Wired}, [this] () -> SettingWidget * {
+            return new WiredConnectionWidget(m_connection->setting(NetworkManager::Setting::Wired), this);
+        });
+        addSettingWidget(i18n("802.1x Security"), {NetworkManager::Setting::Security8021x}, [this] () -> SettingWidget * {
+            return new WiredSecurity(m_connection->setting(NetworkManager::Setting::Security8021x).staticCast<NetworkManager::Security8021xSetting>(), this);
+        });
     } else if (type == NetworkManager::ConnectionSettings::Wireless) {
-        WifiConnectionWidget *wifiWidget = new WifiConnectionWidget(m_connection->setting(NetworkManager::Setting::Wireless), this);
-        addSettingWidget(wifiWidget, i18n("Wi-Fi"));
-        WifiSecurity *wifiSecurity = new WifiSecurity(m_connection->setting(NetworkManager::Setting::WirelessSecurity),
-                m_connection->setting(NetworkManager::Setting::Security8021x).staticCast<NetworkManager::Security8021xSetting>(),
-                this);
-        addSettingWidget(wifiSecurity, i18n("Wi-Fi Security"));
-        connect(wifiWidget, QOverload<const QString &>::of(&WifiConnectionWidget::ssidChanged), wifiSecurity, &WifiSecurity::onSsidChanged);
+        addSettingWidget(i18n("Wi-Fi"), {NetworkManager::Setting::Wireless}, [this] () -> SettingWidget * {
+            WifiConnectionWidget *wifiWidget = new WifiConnectionWidget(m_connection->setting(NetworkManager::Setting::Wireless), this);
+            connect(wifiWidget, QOverload<const QString &>::of(&WifiConnectionWidget::ssidChanged), this, [this] (const QString &ssid) {
+                WifiSecurity *wifiSecurity = static_cast<WifiSecurity *>(settingWidget(NetworkManager::Setting::WirelessSecurity));
+                if (wifiSecurity) {
+                    wifiSecurity->onSsidChanged(ssid);
+                }
+            });
+            return wifiWidget;
+        });
+        addSettingWidget(i18n("Wi-Fi Security"), {NetworkManager::Setting::WirelessSecurity, NetworkManager::Setting::Security8021x}, [this] () -> SettingWidget * {
+            return new WifiSecurity(m_connection->setting(NetworkManager::Setting::WirelessSecurity),
+                                    m_connection->setting(NetworkManager::Setting::Security8021x).staticCast<NetworkManager::Security8021xSetting>(),
+                                    this);
+        });
     } else if (type == NetworkManager::ConnectionSettings::Pppoe) { // DSL
-        PppoeWidget *pppoeWidget = new PppoeWidget(m_connection->setting(NetworkManager::Setting::Pppoe), this);
-        addSettingWidget(pppoeWidget, i18n("DSL"));
-        WiredConnectionWidget *wiredWidget = new WiredConnectionWidget(m_connection->setting(NetworkManager::Setting::Wired), this);
-        addSettingWidget(wiredWidget, i18n("Wired"));
+        addSettingWidget(i18n("DSL"), {NetworkManager::Setting::Pppoe}, [this] () -> SettingWidget * {
+            return new PppoeWidget(m_connection->setting(NetworkManager::Setting::Pppoe), this);
+        });
+        addSettingWidget(i18n("Wired"), {NetworkManager::Setting::Wired}, [this] () -> SettingWidget * {
+            return new WiredConnectionWidget(m_connection->setting(NetworkManager::Setting::Wired), this);
+        });
     } else if (type == NetworkManager::ConnectionSettings::Gsm) { // GSM
-        GsmWidget *gsmWidget = new GsmWidget(m_connection->setting(NetworkManager::Setting::Gsm), this);
-        addSettingWidget(gsmWidget, i18n("Mobile Broadband (%1)", m_connection->typeAsString(m_connection->connectionType())));
+        addSettingWidget(i18n("Mobile Broadband (%1)", m_connection->typeAsString(m_connection->connectionType())), {NetworkManager::Setting::Gsm}, [this] () -> SettingWidget * {
+            return new GsmWidget(m_connection->setting(NetworkManager::Setting::Gsm), this);
+        });
     } else if (type == NetworkManager::ConnectionSettings::Cdma) { // CDMA
-        CdmaWidget *cdmaWidget = new CdmaWidget(m_connection->setting(NetworkManager::Setting::Cdma), this);
-        addSettingWidget(cdmaWidget, i18n("Mobile Broadband (%1)", m_connection->typeAsString(m_connection->connectionType())));
+        addSettingWidget(i18n("Mobile Broadband (%1)", m_connection->typeAsString(m_connection->connectionType())), {NetworkManager::Setting::Cdma}, [this] () -> SettingWidget * {
+            return new CdmaWidget(m_connection->setting(NetworkManager::Setting::Cdma), this);
+        });
     } else if (type == NetworkManager::ConnectionSettings::Bluetooth) {  // Bluetooth
-        BtWidget *btWidget = new BtWidget(m_connection->setting(NetworkManager::Setting::Bluetooth), this);
-        addSettingWidget(btWidget, i18n("Bluetooth"));
+        addSettingWidget(i18n("Bluetooth"), {NetworkManager::Setting::Bluetooth}, [this] () -> SettingWidget * {
+            return new BtWidget(m_connection->setting(NetworkManager::Setting::Bluetooth), this);
+        });
         NetworkManager::BluetoothSetting::Ptr btSetting = m_connection->setting(NetworkManager::Setting::Bluetooth).staticCast<NetworkManager::BluetoothSetting>();
         if (btSetting->profileType() == NetworkManager::BluetoothSetting::Dun) {
-            GsmWidget *gsmWidget = new GsmWidget(m_connection->setting(NetworkManager::Setting::Gsm), this);
-            addSettingWidget(gsmWidget, i18n("GSM"));
-            PPPWidget *pppWidget = new PPPWidget(m_connection->setting(NetworkManager::Setting::Ppp), this);
-            addSettingWidget(pppWidget, i18n("PPP"));
+            addSettingWidget(i18n("GSM"), {NetworkManager::Setting::Gsm}, [this] () -> SettingWidget * {
+                return new GsmWidget(m_connection->setting(NetworkManager::Setting::Gsm), this);
+            });
+            addSettingWidget(i18n("PPP"), {NetworkManager::Setting::Ppp}, [this] () -> SettingWidget * {
+                return new PPPWidget(m_connection->setting(NetworkManager::Setting::Ppp), this);
+            });
         }
     } else if (type == NetworkManager::ConnectionSettings::Infiniband) { // Infiniband
-        InfinibandWidget *infinibandWidget = new InfinibandWidget(m_connection->setting(NetworkManager::Setting::Infiniband), this);
-        addSettingWidget(infinibandWidget, i18n("Infiniband"));
+        addSettingWidget(i18n("Infiniband"), {NetworkManager::Setting::Infiniband}, [this] () -> SettingWidget * {
+            return new InfinibandWidget(m_connection->setting(NetworkManager::Setting::Infiniband), this);
+        });
     } else if (type == NetworkManager::ConnectionSettings::Bond) { // Bond
-        BondWidget *bondWidget = new BondWidget(m_connection->uuid(), m_connection->id(), m_connection->setting(NetworkManager::Setting::Bond), this);
-        addSettingWidget(bondWidget, i18n("Bond"));
+        addSettingWidget(i18n("Bond"), {NetworkManager::Setting::Bond}, [this] () -> SettingWidget * {
+            return new BondWidget(m_connection->uuid(), m_connection->id(), m_connection->setting(NetworkManager::Setting::Bond), this);
+        });
     } else if (type == NetworkManager::ConnectionSettings::Bridge) { // Bridge
-        BridgeWidget *bridgeWidget = new BridgeWidget(m_connection->uuid(), m_connection->id(), m_connection->setting(NetworkManager::Setting::Bridge), this);
-        addSettingWidget(bridgeWidget, i18n("Bridge"));
+        addSettingWidget(i18n("Bridge"), {NetworkManager::Setting::Bridge}, [this] () -> SettingWidget * {
+            return new BridgeWidget(m_connection->uuid(), m_connection->id(), m_connection->setting(NetworkManager::Setting::Bridge), this);
+        });
     } else if (type == NetworkManager::ConnectionSettings::Vlan) { // Vlan
-        VlanWidget *vlanWidget = new VlanWidget(m_connection->setting(NetworkManager::Setting::Vlan), this);
-        addSettingWidget(vlanWidget, i18n("Vlan"));
+        addSettingWidget(i18n("Vlan"), {NetworkManager::Setting::Vlan}, [this] () -> SettingWidget * {
+            return new VlanWidget(m_connection->setting(NetworkManager::Setting::Vlan), this);
+        });
     } else if (type == NetworkManager::ConnectionSettings::Team) { // Team
-        TeamWidget *teamWidget = new TeamWidget(m_connection->uuid(), m_connection->id(), m_connection->setting(NetworkManager::Setting::Team), this);
-        addSettingWidget(teamWidget, i18n("Team"));
+        addSettingWidget(i18n("Team"), {NetworkManager::Setting::Team}, [this] () -> SettingWidget * {
+            return new TeamWidget(m_connection->uuid(), m_connection->id(), m_connection->setting(NetworkManager::Setting::Team), this);
+        });
     } else if (type == NetworkManager::ConnectionSettings::WireGuard) { // WireGuard
-        WireGuardInterfaceWidget *wireGuardInterfaceWidget = new WireGuardInterfaceWidget(m_connection->setting(NetworkManager::Setting::WireGuard), this);
-        addSettingWidget(wireGuardInterfaceWidget, i18n("WireGuard Interface"));
+        addSettingWidget(i18n("WireGuard Interface"), {NetworkManager::Setting::WireGuard}, [this] () -> SettingWidget * {
+            return new WireGuardInterfaceWidget(m_connection->setting(NetworkManager::Setting::WireGuard), this);
+        });
     } else if (type == NetworkManager::ConnectionSettings::Vpn) { // VPN
-        QString error;
-        VpnUiPlugin *vpnPlugin = nullptr;
         NetworkManager::VpnSetting::Ptr vpnSetting =
             m_connection->setting(NetworkManager::Setting::Vpn).staticCast<NetworkManager::VpnSetting>();
         if (!vpnSetting) {
             qCWarning(PLASMA_NM) << "Missing VPN setting!";
         } else {
             serviceType = vpnSetting->serviceType();
-            vpnPlugin = KServiceTypeTrader::createInstanceFromQuery<VpnUiPlugin>(QString::fromLatin1("PlasmaNetworkManagement/VpnUiPlugin"),
-                        QString::fromLatin1("[X-NetworkManager-Services]=='%1'").arg(serviceType),
-                        this, QVariantList(), &error);
-            if (vpnPlugin && error.isEmpty()) {
+            // Only look the plugin up here, loading it is left to when the tab is shown
+            const KService::List services = KServiceTypeTrader::self()->query(QString::fromLatin1("PlasmaNetworkManagement/VpnUiPlugin"),
+                                            QString::fromLatin1("[X-NetworkManager-Services]=='%1'").arg(serviceType));
+            if (!services.isEmpty()) {
                 const QString shortName = serviceType.section('.', -1);
-                SettingWidget *vpnWidget = vpnPlugin->widget(vpnSetting, this);
-                addSettingWidget(vpnWidget, i18n("VPN (%1)", shortName));
+                const KService::Ptr service = services.first();
+                addSettingWidget(i18n("VPN (%1)", shortName), {NetworkManager::Setting::Vpn}, [this, service, vpnSetting, serviceType] () -> SettingWidget * {
+                    QString error;
+                    VpnUiPlugin *vpnPlugin = service->createInstance<VpnUiPlugin>(this, QVariantList(), &error);
+                    if (!vpnPlugin || !error.isEmpty()) {
+                        qCWarning(PLASMA_NM) << error << ", serviceType == " << serviceType;
+                        return nullptr;
+                    }
+                    return vpnPlugin->widget(vpnSetting, this);
+                });
             } else {
-                qCWarning(PLASMA_NM) << error << ", serviceType == " << serviceType;
+                qCWarning(PLASMA_NM) << "No VPN plugin found, serviceType == " << serviceType;
             }
         }
     }
 
     // PPP widget
     if (type == NetworkManager::ConnectionSettings::Pppoe || type == NetworkManager::ConnectionSettings::Cdma || type == NetworkManager::ConnectionSettings::Gsm) {
-        PPPWidget *pppWidget = new PPPWidget(m_connection->setting(NetworkManager::Setting::Ppp), this);
-        addSettingWidget(pppWidget, i18n("PPP"));
+        addSettingWidget(i18n("PPP"), {NetworkManager::Setting::Ppp}, [this] () -> SettingWidget * {
+            return new PPPWidget(m_connection->setting(NetworkManager::Setting::Ppp), this);
+        });
     }
 
     // IPv4 widget
     if (!m_connection->isSlave()) {
-        IPv4Widget *ipv4Widget = new IPv4Widget(m_connection->setting(NetworkManager::Setting::Ipv4), this);
-        addSettingWidget(ipv4Widget, i18n("IPv4"));
+        addSettingWidget(i18n("IPv4"), {NetworkManager::Setting::Ipv4}, [this] () -> SettingWidget * {
+            return new IPv4Widget(m_connection->setting(NetworkManager::Setting::Ipv4), this);
+        });
     }
 
     // IPv6 widget
@@ -307,16 +530,13 @@ void ConnectionEditorBase::initialize()
             || type == NetworkManager::ConnectionSettings::Vlan
             || type == NetworkManager::ConnectionSettings::WireGuard
             || (type == NetworkManager::ConnectionSettings::Vpn && serviceType == QLatin1String("org.freedesktop.NetworkManager.openvpn"))) && !m_connection->isSlave()) {
-        IPv6Widget *ipv6Widget = new IPv6Widget(m_connection->setting(NetworkManager::Setting::Ipv6), this);
-        addSettingWidget(ipv6Widget, i18n("IPv6"));
+        addSettingWidget(i18n("IPv6"), {NetworkManager::Setting::Ipv6}, [this] () -> SettingWidget * {
+            return new IPv6Widget(m_connection->setting(NetworkManager::Setting::Ipv6), this);
+        });
     }
 
-    // Re-check validation
-    bool valid = true;
-    for (SettingWidget *widget : m_settingWidgets) {
-        valid = valid && widget->isValid();
-        connect(widget, &SettingWidget::validChanged, this, &ConnectionEditorBase::validChanged);
-    }
+    // Re-check validation, tabs not created yet are validated from their settings
+    const bool valid = tabsValid();
 
     m_valid = valid;
     Q_EMIT validityChanged(valid);
@@ -465,11 +685,9 @@ void ConnectionEditorBase::replyFinished(QDBusPendingCallWatcher *watcher)
                 NetworkManager::Setting::Ptr setting = m_connection->setting(NetworkManager::Setting::typeFromString(key));
                 if (setting) {
                     setting->secretsFromMap(secrets.value(key));
+                    m_loadedSecrets << settingName;
                     for (SettingWidget *widget : m_settingWidgets) {
-                        const QString type = widget->type();
-                        if (type == settingName ||
-                                (settingName == NetworkManager::Setting::typeAsString(NetworkManager::Setting::Security8021x) &&
-                                 type == NetworkManager::Setting::typeAsString(NetworkManager::Setting::WirelessSecurity))) {
+                        if (secretsBelongTo(settingName, widget->type())) {
                             widget->loadSecrets(setting);
                         }
                     }
@@ -499,14 +717,10 @@ void ConnectionEditorBase::validChanged(bool valid)
         m_valid = false;
         Q_EMIT validityChanged(false);
         return;
-    } else {
-        for (SettingWidget *widget : m_settingWidgets) {
-            if (!widget->isValid()) {
-                m_valid = false;
-                Q_EMIT validityChanged(false);
-                return;
-            }
-        }
+    } else if (!tabsValid()) {
+        m_valid = false;
+        Q_EMIT validityChanged(false);
+        return;
     }
 
     m_valid = true;
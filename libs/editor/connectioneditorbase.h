@@ -26,6 +26,8 @@
 
 #include <NetworkManagerQt/ConnectionSettings>
 
+#include <functional>
+
 class ConnectionWidget;
 class SettingWidget;
 
@@ -71,16 +73,39 @@ protected:
     // Subclassed widget is supposed to call initialization after the UI is initialized
     void initialize();
 
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private:
+    // Setting widgets of existing connections are only created once their tab is shown,
+    // until then the original settings of the connection are used in their place
+    struct SettingTab {
+        QWidget *page;
+        // Setting types the widget writes
+        QStringList types;
+        std::function<SettingWidget *()> factory;
+        SettingWidget *widget;
+    };
+
     bool m_initialized;
     bool m_valid;
+    bool m_lazyTabs;
     int m_pendingReplies;
     NetworkManager::ConnectionSettings::Ptr m_connection;
     ConnectionWidget *m_connectionWidget;
     QList<SettingWidget *> m_settingWidgets;
+    QList<SettingTab> m_settingTabs;
+    // Settings whose secrets were received, for widgets created afterwards
+    QStringList m_loadedSecrets;
 
     void addConnectionWidget(ConnectionWidget *widget, const QString &text);
-    void addSettingWidget(SettingWidget *widget, const QString &text);
+    void addSettingWidget(const QString &text, const QList<NetworkManager::Setting::SettingType> &types, const std::function<SettingWidget *()> &factory);
+    SettingWidget *createSettingWidget(SettingTab &tab);
+    // Returns the widget of given setting type, creating it when needed
+    SettingWidget *settingWidget(NetworkManager::Setting::SettingType type);
+    // Validity of created widgets and of the settings of tabs not created yet
+    bool tabsValid() const;
+    static bool settingIsValid(const NetworkManager::Setting::Ptr &setting);
+    static bool secretsBelongTo(const QString &settingName, const QString &type);
 
 };
 
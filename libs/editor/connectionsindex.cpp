@@ -0,0 +1,163 @@
+/*
+    Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "connectionsindex.h"
+
+#include <NetworkManagerQt/Settings>
+
+Q_GLOBAL_STATIC(ConnectionsIndex, s_connectionsIndex)
+
+ConnectionsIndex *ConnectionsIndex::self()
+{
+    return s_connectionsIndex;
+}
+
+ConnectionsIndex::ConnectionsIndex()
+    : QObject()
+{
+    for (const NetworkManager::Connection::Ptr &connection : NetworkManager::listConnections()) {
+        addToIndex(connection);
+    }
+
+    connect(NetworkManager::settingsNotifier(), &NetworkManager::SettingsNotifier::connectionAdded, this, &ConnectionsIndex::connectionAdded);
+    connect(NetworkManager::settingsNotifier(), &NetworkManager::SettingsNotifier::connectionRemoved, this, &ConnectionsIndex::connectionRemoved);
+}
+
+ConnectionsIndex::~ConnectionsIndex()
+{
+}
+
+NetworkManager::Connection::List ConnectionsIndex::connections(NetworkManager::ConnectionSettings::ConnectionType type) const
+{
+    return m_byType.value(type).values();
+}
+
+NetworkManager::Connection::Ptr ConnectionsIndex::connectionByUuid(const QString &uuid) const
+{
+    return m_byUuid.value(uuid);
+}
+
+NetworkManager::Connection::Ptr ConnectionsIndex::bluetoothConnection(const QByteArray &address, NetworkManager::BluetoothSetting::ProfileType profile) const
+{
+    return m_byBluetooth.value(bluetoothKey(address, profile));
+}
+
+NetworkManager::Connection::List ConnectionsIndex::slaves(const QString &master) const
+{
+    if (master.isEmpty()) {
+        return {};
+    }
+
+    return m_byMaster.value(master).values();
+}
+
+void ConnectionsIndex::connectionAdded(const QString &path)
+{
+    NetworkManager::Connection::Ptr connection = NetworkManager::findConnection(path);
+    if (connection) {
+        addToIndex(connection);
+        Q_EMIT indexChanged();
+    }
+}
+
+void ConnectionsIndex::connectionRemoved(const QString &path)
+{
+    if (m_entries.contains(path)) {
+        removeFromIndex(path);
+        Q_EMIT indexChanged();
+    }
+}
+
+QString ConnectionsIndex::bluetoothKey(const QByteArray &address, NetworkManager::BluetoothSetting::ProfileType profile)
+{
+    return QString::fromLatin1(address.toHex()) + QLatin1Char(';') + QString::number(profile);
+}
+
+void ConnectionsIndex::addToIndex(const NetworkManager::Connection::Ptr &connection)
+{
+    const QString path = connection->path();
+    quint64 sequence;
+    if (m_entries.contains(path)) {
+        sequence = m_entries.value(path).sequence;
+        removeFromIndex(path);
+    } else {
+        sequence = m_nextSequence++;
+        connect(connection.data(), &NetworkManager::Connection::updated, this, [this, path] () {
+            NetworkManager::Connection::Ptr connection = m_entries.value(path).connection;
+            if (connection) {
+                addToIndex(connection);
+                Q_EMIT indexChanged();
+            }
+        });
+    }
+
+    NetworkManager::ConnectionSettings::Ptr settings = connection->settings();
+
+    Entry entry;
+    entry.connection = connection;
+    entry.type = settings->connectionType();
+    entry.uuid = settings->uuid();
+    entry.master = settings->master();
+    entry.sequence = sequence;
+
+    if (entry.type == NetworkManager::ConnectionSettings::Bluetooth) {
+        NetworkManager::BluetoothSetting::Ptr btSetting = settings->setting(NetworkManager::Setting::Bluetooth).staticCast<NetworkManager::BluetoothSetting>();
+        if (btSetting) {
+            entry.bluetoothKey = bluetoothKey(btSetting->bluetoothAddress(), btSetting->profileType());
+            m_byBluetooth.insert(entry.bluetoothKey, connection);
+        }
+    }
+
+    m_byType[entry.type].insert(entry.sequence, connection);
+    m_byUuid.insert(entry.uuid, connection);
+    if (!entry.master.isEmpty()) {
+        m_byMaster[entry.master].insert(entry.sequence, connection);
+    }
+
+    m_entries.insert(path, entry);
+}
+
+void ConnectionsIndex::removeFromIndex(const QString &path)
+{
+    const Entry entry = m_entries.take(path);
+
+    auto typeIt = m_byType.find(entry.type);
+    if (typeIt != m_byType.end()) {
+        typeIt->remove(entry.sequence);
+    }
+
+    if (m_byUuid.value(entry.uuid) == entry.connection) {
+        m_byUuid.remove(entry.uuid);
+    }
+
+    if (!entry.bluetoothKey.isEmpty() && m_byBluetooth.value(entry.bluetoothKey) == entry.connection) {
+        m_byBluetooth.remove(entry.bluetoothKey);
+    }
+
+    if (!entry.master.isEmpty()) {
+        auto masterIt = m_byMaster.find(entry.master);
+        if (masterIt != m_byMaster.end()) {
+            masterIt->remove(entry.sequence);
+            if (masterIt->isEmpty()) {
+                m_byMaster.erase(masterIt);
+            }
+        }
+    }
+}
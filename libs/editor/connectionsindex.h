@@ -0,0 +1,95 @@
+/*
+    Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLASMA_NM_CONNECTIONS_INDEX_H
+#define PLASMA_NM_CONNECTIONS_INDEX_H
+
+#include <QHash>
+#include <QMap>
+#include <QObject>
+
+#include <NetworkManagerQt/BluetoothSetting>
+#include <NetworkManagerQt/Connection>
+#include <NetworkManagerQt/ConnectionSettings>
+
+/**
+ * Process-wide index of connection profiles, so callers don't have to walk
+ * NetworkManager::listConnections() and parse settings of every profile to
+ * find the few they are interested in.
+ *
+ * The index is kept up to date from SettingsNotifier::connectionAdded/connectionRemoved
+ * and Connection::updated.
+ */
+class Q_DECL_EXPORT ConnectionsIndex : public QObject
+{
+    Q_OBJECT
+public:
+    static ConnectionsIndex *self();
+
+    ConnectionsIndex();
+    ~ConnectionsIndex() override;
+
+    /**
+     * Returns all connections of given type, in the order they were added
+     */
+    NetworkManager::Connection::List connections(NetworkManager::ConnectionSettings::ConnectionType type) const;
+    NetworkManager::Connection::Ptr connectionByUuid(const QString &uuid) const;
+    /**
+     * Returns the Bluetooth connection for given device and profile, if there is any
+     */
+    NetworkManager::Connection::Ptr bluetoothConnection(const QByteArray &address, NetworkManager::BluetoothSetting::ProfileType profile) const;
+    /**
+     * Returns connections whose master is @master, which can be either uuid,
+     * connection id or interface name depending on how the slave refers to it
+     */
+    NetworkManager::Connection::List slaves(const QString &master) const;
+
+Q_SIGNALS:
+    void indexChanged();
+
+private Q_SLOTS:
+    void connectionAdded(const QString &path);
+    void connectionRemoved(const QString &path);
+
+private:
+    // What a connection was indexed under, so it can be removed again after an update
+    struct Entry {
+        NetworkManager::Connection::Ptr connection;
+        NetworkManager::ConnectionSettings::ConnectionType type;
+        QString uuid;
+        QString bluetoothKey;
+        QString master;
+        // Keeps results in the order connections were first seen, like listConnections()
+        quint64 sequence = 0;
+    };
+
+    static QString bluetoothKey(const QByteArray &address, NetworkManager::BluetoothSetting::ProfileType profile);
+    void addToIndex(const NetworkManager::Connection::Ptr &connection);
+    void removeFromIndex(const QString &path);
+
+    QHash<QString, Entry> m_entries;
+    QHash<int, QMap<quint64, NetworkManager::Connection::Ptr>> m_byType;
+    QHash<QString, NetworkManager::Connection::Ptr> m_byUuid;
+    QHash<QString, NetworkManager::Connection::Ptr> m_byBluetooth;
+    QHash<QString, QMap<quint64, NetworkManager::Connection::Ptr>> m_byMaster;
+    quint64 m_nextSequence = 0;
+};
+
+#endif // PLASMA_NM_CONNECTIONS_INDEX_H
@@ -0,0 +1,119 @@
+/*
+    Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "firewallzones.h"
+#include "debug.h"
+
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusServiceWatcher>
+
+#define FIREWALLD_PATH "/org/fedoraproject/FirewallD1"
+#define FIREWALLD_IFACE "org.fedoraproject.FirewallD1"
+#define FIREWALLD_ZONE_IFACE "org.fedoraproject.FirewallD1.zone"
+
+Q_GLOBAL_STATIC(FirewallZones, s_firewallZones)
+
+FirewallZones *FirewallZones::self()
+{
+    return s_firewallZones;
+}
+
+FirewallZones::FirewallZones(QObject *parent)
+    : FirewallZones(QDBusConnection::systemBus(), QStringLiteral(FIREWALLD_IFACE), parent)
+{
+}
+
+FirewallZones::FirewallZones(const QDBusConnection &bus, const QString &service, QObject *parent)
+    : QObject(parent)
+    , m_bus(bus)
+    , m_service(service)
+    , m_pendingCall(nullptr)
+    , m_ready(false)
+{
+    m_bus.connect(m_service, QStringLiteral(FIREWALLD_PATH), QStringLiteral(FIREWALLD_IFACE), QStringLiteral("Reloaded"),
+                  this, SLOT(reload()));
+
+    m_serviceWatcher = new QDBusServiceWatcher(m_service, m_bus, QDBusServiceWatcher::WatchForOwnerChange, this);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceRegistered, this, &FirewallZones::reload);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &FirewallZones::serviceUnregistered);
+
+    reload();
+}
+
+FirewallZones::~FirewallZones()
+{
+}
+
+bool FirewallZones::isReady() const
+{
+    return m_ready;
+}
+
+QStringList FirewallZones::zones() const
+{
+    return m_zones;
+}
+
+void FirewallZones::reload()
+{
+    // Only the newest answer counts
+    delete m_pendingCall;
+
+    const QDBusMessage message = QDBusMessage::createMethodCall(m_service, QStringLiteral(FIREWALLD_PATH), QStringLiteral(FIREWALLD_ZONE_IFACE), QStringLiteral("getZones"));
+    m_pendingCall = new QDBusPendingCallWatcher(m_bus.asyncCall(message), this);
+    connect(m_pendingCall, &QDBusPendingCallWatcher::finished, this, &FirewallZones::zonesReceived);
+}
+
+void FirewallZones::zonesReceived(QDBusPendingCallWatcher *watcher)
+{
+    const QDBusPendingReply<QStringList> reply = *watcher;
+    watcher->deleteLater();
+    m_pendingCall = nullptr;
+
+    if (reply.isValid()) {
+        setZones(reply.value());
+    } else {
+        // FirewallD not running is a valid state too, there are simply no zones
+        qCDebug(PLASMA_NM) << "Failed to get firewall zones:" << reply.error().message();
+        setZones(QStringList());
+    }
+}
+
+void FirewallZones::serviceUnregistered()
+{
+    delete m_pendingCall;
+    m_pendingCall = nullptr;
+    setZones(QStringList());
+}
+
+void FirewallZones::setZones(const QStringList &zones)
+{
+    const bool wasReady = m_ready;
+    m_ready = true;
+
+    if (wasReady && zones == m_zones) {
+        return;
+    }
+
+    m_zones = zones;
+    Q_EMIT zonesChanged(m_zones);
+}
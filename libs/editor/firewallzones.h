@@ -0,0 +1,78 @@
+/*
+    Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLASMA_NM_FIREWALL_ZONES_H
+#define PLASMA_NM_FIREWALL_ZONES_H
+
+#include <QDBusConnection>
+#include <QObject>
+#include <QStringList>
+
+class QDBusPendingCallWatcher;
+class QDBusServiceWatcher;
+
+/**
+ * Firewall zones known to FirewallD.
+ *
+ * Zones are fetched asynchronously once per session and refreshed when FirewallD
+ * reloads or restarts, so connection editors never have to wait for FirewallD,
+ * which may take long to answer or not run at all.
+ */
+class Q_DECL_EXPORT FirewallZones : public QObject
+{
+    Q_OBJECT
+public:
+    static FirewallZones *self();
+
+    explicit FirewallZones(QObject *parent = nullptr);
+    /**
+     * @bus - connection where the FirewallD service lives
+     * @service - name of the FirewallD service, "org.fedoraproject.FirewallD1" for the real one
+     */
+    FirewallZones(const QDBusConnection &bus, const QString &service, QObject *parent = nullptr);
+    ~FirewallZones() override;
+
+    /**
+     * True once FirewallD answered (or turned out not to be available)
+     */
+    bool isReady() const;
+
+    QStringList zones() const;
+
+Q_SIGNALS:
+    void zonesChanged(const QStringList &zones);
+
+private Q_SLOTS:
+    void reload();
+    void zonesReceived(QDBusPendingCallWatcher *watcher);
+    void serviceUnregistered();
+
+private:
+    void setZones(const QStringList &zones);
+
+    QDBusConnection m_bus;
+    QString m_service;
+    QDBusServiceWatcher *m_serviceWatcher;
+    QDBusPendingCallWatcher *m_pendingCall;
+    QStringList m_zones;
+    bool m_ready;
+};
+
+#endif // PLASMA_NM_FIREWALL_ZONES_H
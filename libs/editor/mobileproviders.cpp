@@ -21,9 +21,18 @@
 #include "debug.h"
 #include "mobileproviders.h"
 
-#include <QFile>
-#include <QTextStream>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
 #include <QLocale>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QXmlStreamReader>
+
+// Bump whenever the layout of the cache changes
+#define MOBILE_PROVIDERS_CACHE_MAGIC 0x504e4d50
+#define MOBILE_PROVIDERS_CACHE_VERSION 2
 
 const QString MobileProviders::ProvidersFile = "/usr/share/mobile-broadband-provider-info/serviceproviders.xml";
 
@@ -31,66 +40,101 @@ bool localeAwareCompare(const QString & one, const QString & two) {
     return one.localeAwareCompare(two) < 0;
 }
 
-MobileProviders::MobileProviders()
+namespace
+{
+// Country names don't change while the process runs, so collect them once
+// instead of building a QLocale for every country in each MobileProviders
+class CountryTable
 {
-    for (int c = 1; c <= QLocale::LastCountry; c++) {
-        const auto country = static_cast<QLocale::Country>(c);
-        QLocale locale(QLocale::AnyLanguage, country);
-        if (locale.country() == country) {
-            const QString localeName = locale.name();
-            const auto idx = localeName.indexOf(QLatin1Char('_'));
-            if (idx != -1) {
-                const QString countryCode = localeName.mid(idx + 1);
-                QString countryName = locale.nativeCountryName();
-                if (countryName.isEmpty()) {
-                    countryName = QLocale::countryToString(country);
+public:
+    CountryTable()
+    {
+        for (int c = 1; c <= QLocale::LastCountry; c++) {
+            const auto country = static_cast<QLocale::Country>(c);
+            QLocale locale(QLocale::AnyLanguage, country);
+            if (locale.country() == country) {
+                const QString localeName = locale.name();
+                const auto idx = localeName.indexOf(QLatin1Char('_'));
+                if (idx != -1) {
+                    const QString countryCode = localeName.mid(idx + 1);
+                    QString countryName = locale.nativeCountryName();
+                    if (countryName.isEmpty()) {
+                        countryName = QLocale::countryToString(country);
+                    }
+                    names.insert(countryCode, countryName);
+                    codes.insert(countryName, countryCode);
                 }
-                mCountries.insert(countryCode, countryName);
             }
         }
     }
-    mError = Success;
 
-    QFile file2(ProvidersFile);
+    // Country names sorted for the current locale
+    QStringList sortedNames()
+    {
+        const QString locale = QLocale().name();
+        if (locale != sortedLocale) {
+            sorted = names.values();
+            std::sort(sorted.begin(), sorted.end(), localeAwareCompare);
+            sortedLocale = locale;
+        }
+        return sorted;
+    }
 
-    if (file2.open(QIODevice::ReadOnly)) {
-        if (mDocProviders.setContent(&file2)) {
-            docElement = mDocProviders.documentElement();
+    QHash<QString, QString> names;
+    QHash<QString, QString> codes;
 
-            if (docElement.isNull()) {
-                qCWarning(PLASMA_NM) << ProvidersFile << ": document is null";
-                mError = ProvidersIsNull;
-            } else {
-                if (docElement.isNull() || docElement.tagName() != "serviceproviders") {
-                    qCWarning(PLASMA_NM) << ProvidersFile << ": wrong format";
-                    mError = ProvidersWrongFormat;
-                } else {
-                    if (docElement.attribute("format") != "2.0") {
-                        qCWarning(PLASMA_NM) << ProvidersFile << ": mobile broadband provider database format '" << docElement.attribute("format") << "' not supported.";
-                        mError = ProvidersFormatNotSupported;
-                    } else {
-                        // qCDebug(PLASMA_NM) << "Everything is alright so far";
-                    }
-                }
-            }
-        }
+private:
+    QStringList sorted;
+    QString sortedLocale;
+};
+}
 
-        file2.close();
-    } else {
-        qCWarning(PLASMA_NM) << "Error opening providers file" << ProvidersFile;
+Q_GLOBAL_STATIC(CountryTable, s_countryTable)
+
+MobileProviders::MobileProviders()
+    : MobileProviders(ProvidersFile)
+{
+}
+
+MobileProviders::MobileProviders(const QString &providersFile)
+    : mCountries(s_countryTable->names)
+    , mError(Success)
+    , mProvidersFile(providersFile)
+{
+    const QFileInfo providersInfo(mProvidersFile);
+    if (!providersInfo.exists()) {
+        qCWarning(PLASMA_NM) << "Error opening providers file" << mProvidersFile;
         mError = ProvidersMissing;
+        return;
+    }
+
+    if (loadCache(providersInfo)) {
+        return;
+    }
+
+    QHash<QString, ProviderList> providers;
+    if (parseProviders(providers)) {
+        mNetworkIndex = networkIndex(providers);
+        writeCache(providers, providersInfo);
+        mProviders = providers;
     }
 }
 
 MobileProviders::~MobileProviders()
 {
+    if (mCacheData) {
+        mCacheFile.unmap(const_cast<uchar *>(mCacheData));
+    }
+}
+
+QString MobileProviders::cacheFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/plasma-nm/mobileproviders.cache");
 }
 
 QStringList MobileProviders::getCountryList() const
 {
-    QStringList temp = mCountries.values();
-    std::sort(temp.begin(), temp.end(), localeAwareCompare);
-    return temp;
+    return s_countryTable->sortedNames();
 }
 
 QString MobileProviders::countryFromLocale() const
@@ -107,64 +151,24 @@ QStringList MobileProviders::getProvidersList(QString country, NetworkManager::C
 {
     mProvidersGsm.clear();
     mProvidersCdma.clear();
-    QDomNode n = docElement.firstChild();
 
     // country is a country name and we parse country codes.
-    if (!mCountries.key(country).isNull()) {
-        country = mCountries.key(country);
+    const QString countryCode = s_countryTable->codes.value(country);
+    if (!countryCode.isNull()) {
+        country = countryCode;
     }
     QMap<QString, QString> sortedGsm;
     QMap<QString, QString> sortedCdma;
-    while (!n.isNull()) {
-        QDomElement e = n.toElement(); // <country ...>
-
-        if (!e.isNull() && e.attribute("code").toUpper() == country) {
-            QDomNode n2 = e.firstChild();
-            while (!n2.isNull()) {
-                QDomElement e2 = n2.toElement(); // <provider ...>
-
-                if (!e2.isNull() && e2.tagName().toLower() == "provider") {
-                    QDomNode n3 = e2.firstChild();
-                    bool hasGsm = false;
-                    bool hasCdma = false;
-                    QMap<QString, QString> localizedProviderNames;
-
-                    while (!n3.isNull()) {
-                        QDomElement e3 = n3.toElement(); // <name | gsm | cdma>
-
-                        if (!e3.isNull()) {
-                            if (e3.tagName().toLower() == "gsm") {
-                                hasGsm = true;
-                            } else if (e3.tagName().toLower() == "cdma") {
-                                hasCdma = true;
-                            } else if (e3.tagName().toLower() == "name") {
-                                QString lang = e3.attribute("xml:lang");
-                                if (lang.isEmpty()) {
-                                    lang = "en";     // English is default
-                                } else {
-                                    lang = lang.toLower();
-                                    lang.remove(QRegExp("\\-.*$"));  // Remove everything after '-' in xml:lang attribute.
-                                }
-                                localizedProviderNames.insert(lang, e3.text());
-                            }
-                        }
-                        n3 = n3.nextSibling();
-                    }
-                    const QString name = getNameByLocale(localizedProviderNames);
-                    if (hasGsm) {
-                        mProvidersGsm.insert(name, e2.firstChild());
-                        sortedGsm.insert(name.toLower(), name);
-                    }
-                    if (hasCdma) {
-                        mProvidersCdma.insert(name, e2.firstChild());
-                        sortedCdma.insert(name.toLower(), name);
-                    }
-                }
-                n2 = n2.nextSibling();
-            }
-            break;
+    for (const ProviderEntry &provider : providersForCountry(country)) {
+        const QString name = getNameByLocale(provider.names);
+        if (provider.gsm) {
+            mProvidersGsm.insert(name, provider);
+            sortedGsm.insert(name.toLower(), name);
+        }
+        if (provider.cdma) {
+            mProvidersCdma.insert(name, provider);
+            sortedCdma.insert(name.toLower(), name);
         }
-        n = n.nextSibling();
     }
 
     if (type == NetworkManager::ConnectionSettings::Gsm) {
@@ -181,43 +185,11 @@ QStringList MobileProviders::getApns(const QString & provider)
         return QStringList();
     }
 
-    QDomNode n = mProvidersGsm[provider];
-
-    while (!n.isNull()) {
-        QDomElement e = n.toElement(); // <gsm | cdma>
-
-        if (!e.isNull() && e.tagName().toLower() == "gsm") {
-            QDomNode n2 = e.firstChild();
-            while (!n2.isNull()) {
-                QDomElement e2 = n2.toElement(); // <apn | network-id>
-
-                if (!e2.isNull() && e2.tagName().toLower() == "apn") {
-                    bool isInternet = true;
-                    QDomNode n3 = e2.firstChild();
-                    while (!n3.isNull()) {
-                        QDomElement e3 = n3.toElement(); // <usage>
-                        if (!e3.isNull() &&
-                            e3.tagName().toLower() == "usage" &&
-                            !e3.attribute("type").isNull() &&
-                            e3.attribute("type").toLower() != "internet") {
-                            // qCDebug(PLASMA_NM) << "apn" << e2.attribute("value") << "ignored because of usage" << e3.attribute("type");
-                            isInternet = false;
-                            break;
-                        }
-                        n3 = n3.nextSibling();
-                    }
-                    if (isInternet) {
-                        mApns.insert(e2.attribute("value"), e2.firstChild());
-                    }
-                } else if (!e2.isNull() && e2.tagName().toLower() == "network-id") {
-                    mNetworkIds.append(e2.attribute("mcc") + '-' + e2.attribute("mnc"));
-                }
-
-                n2 = n2.nextSibling();
-            }
-        }
-        n = n.nextSibling();
+    const ProviderEntry entry = mProvidersGsm.value(provider);
+    for (const ApnEntry &apn : entry.apns) {
+        mApns.insert(apn.apn, apn);
     }
+    mNetworkIds = entry.networkIds;
 
     QStringList temp = mApns.keys();
     temp.sort();
@@ -227,51 +199,34 @@ QStringList MobileProviders::getApns(const QString & provider)
 
 QStringList MobileProviders::getNetworkIds(const QString & provider)
 {
-    if (mNetworkIds.isEmpty()) {
-        getApns(provider);
-    }
-    return mNetworkIds;
+    return mProvidersGsm.value(provider).networkIds;
 }
 
 QVariantMap MobileProviders::getApnInfo(const QString & apn)
+{
+    QVariantMap temp = apnInfo(mApns.value(apn));
+    temp.insert("apn", apn);
+    return temp;
+}
+
+QVariantMap MobileProviders::apnInfo(const ApnEntry &entry) const
 {
     QVariantMap temp;
-    QDomNode n = mApns[apn];
-    QStringList dnsList;
-    QMap<QString, QString> localizedPlanNames;
-
-    while (!n.isNull()) {
-        QDomElement e = n.toElement(); // <name|username|password|dns(*)>
-
-        if (!e.isNull()) {
-            if (e.tagName().toLower() == "name") {
-                QString lang = e.attribute("xml:lang");
-                if (lang.isEmpty()) {
-                    lang = "en";     // English is default
-                } else {
-                    lang = lang.toLower();
-                    lang.remove(QRegExp("\\-.*$"));  // Remove everything after '-' in xml:lang attribute.
-                }
-                localizedPlanNames.insert(lang, e.text());
-            } else if (e.tagName().toLower() == "username") {
-                temp.insert("username", e.text());
-            } else if (e.tagName().toLower() == "password") {
-                temp.insert("password", e.text());
-            } else if (e.tagName().toLower() == "dns") {
-                dnsList.append(e.text());
-            }
-        }
 
-        n = n.nextSibling();
+    if (!entry.username.isNull()) {
+        temp.insert("username", entry.username);
+    }
+    if (!entry.password.isNull()) {
+        temp.insert("password", entry.password);
     }
 
-    QString name = getNameByLocale(localizedPlanNames);
+    QString name = getNameByLocale(entry.names);
     if (!name.isEmpty()) {
         temp.insert("name", QVariant::fromValue(name));
     }
     temp.insert("number", getGsmNumber());
-    temp.insert("apn", apn);
-    temp.insert("dnsList", dnsList);
+    temp.insert("apn", entry.apn);
+    temp.insert("dnsList", entry.dns);
 
     return temp;
 }
@@ -283,38 +238,390 @@ QVariantMap MobileProviders::getCdmaInfo(const QString & provider)
     }
 
     QVariantMap temp;
-    QDomNode n = mProvidersCdma[provider];
-    QStringList sidList;
-
-    while (!n.isNull()) {
-        QDomElement e = n.toElement(); // <gsm or cdma ...>
-
-        if (!e.isNull() && e.tagName().toLower() == "cdma") {
-            QDomNode n2 = e.firstChild();
-            while (!n2.isNull()) {
-                QDomElement e2 = n2.toElement(); // <name | username | password | sid>
-
-                if (!e2.isNull()) {
-                    if (e2.tagName().toLower() == "username") {
-                        temp.insert("username", e2.text());
-                    } else if (e2.tagName().toLower() == "password") {
-                        temp.insert("password", e2.text());
-                    } else if (e2.tagName().toLower() == "sid") {
-                        sidList.append(e2.text());
-                    }
+    const ProviderEntry entry = mProvidersCdma.value(provider);
+
+    if (!entry.cdmaUsername.isNull()) {
+        temp.insert("username", entry.cdmaUsername);
+    }
+    if (!entry.cdmaPassword.isNull()) {
+        temp.insert("password", entry.cdmaPassword);
+    }
+
+    temp.insert("number", getCdmaNumber());
+    temp.insert("sidList", entry.sids);
+    return temp;
+}
+
+QVariantMap MobileProviders::getApnInfoByNetworkId(const QString &networkId, const QString &spn)
+{
+    ProviderEntry match;
+    QString country;
+    for (const auto &candidate : mNetworkIndex.value(networkIdKey(networkId))) {
+        const ProviderList providers = providersForCountry(candidate.first);
+        if (candidate.second >= providers.size() || providers.at(candidate.second).apns.isEmpty()) {
+            continue;
+        }
+
+        const ProviderEntry &provider = providers.at(candidate.second);
+        bool spnMatches = false;
+        if (!spn.isEmpty()) {
+            for (const QString &name : provider.names) {
+                if (name.compare(spn, Qt::CaseInsensitive) == 0) {
+                    spnMatches = true;
+                    break;
                 }
+            }
+        }
 
-                n2 = n2.nextSibling();
+        // Take the first provider unless the SIM tells us better
+        if (country.isEmpty() || spnMatches) {
+            match = provider;
+            country = candidate.first;
+            if (spnMatches) {
+                break;
             }
         }
-        n = n.nextSibling();
     }
 
-    temp.insert("number", getCdmaNumber());
-    temp.insert("sidList", sidList);
+    if (country.isEmpty()) {
+        return QVariantMap();
+    }
+
+    QVariantMap temp = apnInfo(match.apns.first());
+    temp.insert("provider", getNameByLocale(match.names));
+    temp.insert("country", country);
     return temp;
 }
 
+bool MobileProviders::parseProviders(QHash<QString, ProviderList> &providers)
+{
+    QFile file(mProvidersFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(PLASMA_NM) << "Error opening providers file" << mProvidersFile;
+        mError = ProvidersMissing;
+        return false;
+    }
+
+    QXmlStreamReader xml(&file);
+
+    if (!xml.readNextStartElement()) {
+        qCWarning(PLASMA_NM) << mProvidersFile << ": document is null";
+        mError = ProvidersIsNull;
+        return false;
+    }
+
+    if (xml.name() != QLatin1String("serviceproviders")) {
+        qCWarning(PLASMA_NM) << mProvidersFile << ": wrong format";
+        mError = ProvidersWrongFormat;
+        return false;
+    }
+
+    if (xml.attributes().value(QLatin1String("format")) != QLatin1String("2.0")) {
+        qCWarning(PLASMA_NM) << mProvidersFile << ": mobile broadband provider database format '" << xml.attributes().value(QLatin1String("format")) << "' not supported.";
+        mError = ProvidersFormatNotSupported;
+        return false;
+    }
+
+    while (xml.readNextStartElement()) {
+        if (xml.name() != QLatin1String("country")) {
+            xml.skipCurrentElement();
+            continue;
+        }
+
+        ProviderList &country = providers[xml.attributes().value(QLatin1String("code")).toString().toUpper()];
+        while (xml.readNextStartElement()) {
+            if (xml.name() == QLatin1String("provider")) {
+                country << readProvider(xml);
+            } else {
+                xml.skipCurrentElement();
+            }
+        }
+    }
+
+    if (xml.hasError()) {
+        qCWarning(PLASMA_NM) << mProvidersFile << ": wrong format" << xml.errorString();
+        mError = ProvidersWrongFormat;
+        return false;
+    }
+
+    return true;
+}
+
+MobileProviders::ProviderEntry MobileProviders::readProvider(QXmlStreamReader &xml)
+{
+    ProviderEntry provider;
+
+    while (xml.readNextStartElement()) {
+        if (xml.name() == QLatin1String("name")) {
+            readName(xml, provider.names);
+        } else if (xml.name() == QLatin1String("gsm")) {
+            provider.gsm = true;
+            while (xml.readNextStartElement()) {
+                if (xml.name() == QLatin1String("apn")) {
+                    bool internet = true;
+                    const ApnEntry apn = readApn(xml, &internet);
+                    if (internet) {
+                        provider.apns << apn;
+                    }
+                } else if (xml.name() == QLatin1String("network-id")) {
+                    provider.networkIds << xml.attributes().value(QLatin1String("mcc")).toString() + QLatin1Char('-') + xml.attributes().value(QLatin1String("mnc")).toString();
+                    xml.skipCurrentElement();
+                } else {
+                    xml.skipCurrentElement();
+                }
+            }
+        } else if (xml.name() == QLatin1String("cdma")) {
+            provider.cdma = true;
+            while (xml.readNextStartElement()) {
+                if (xml.name() == QLatin1String("username")) {
+                    provider.cdmaUsername = xml.readElementText();
+                } else if (xml.name() == QLatin1String("password")) {
+                    provider.cdmaPassword = xml.readElementText();
+                } else if (xml.name() == QLatin1String("sid")) {
+                    provider.sids << xml.readElementText();
+                } else {
+                    xml.skipCurrentElement();
+                }
+            }
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+
+    return provider;
+}
+
+MobileProviders::ApnEntry MobileProviders::readApn(QXmlStreamReader &xml, bool *internet)
+{
+    ApnEntry apn;
+    apn.apn = xml.attributes().value(QLatin1String("value")).toString();
+
+    while (xml.readNextStartElement()) {
+        if (xml.name() == QLatin1String("usage")) {
+            if (xml.attributes().hasAttribute(QLatin1String("type"))
+                && xml.attributes().value(QLatin1String("type")).compare(QLatin1String("internet"), Qt::CaseInsensitive) != 0) {
+                *internet = false;
+            }
+            xml.skipCurrentElement();
+        } else if (xml.name() == QLatin1String("name")) {
+            readName(xml, apn.names);
+        } else if (xml.name() == QLatin1String("username")) {
+            apn.username = xml.readElementText();
+        } else if (xml.name() == QLatin1String("password")) {
+            apn.password = xml.readElementText();
+        } else if (xml.name() == QLatin1String("dns")) {
+            apn.dns << xml.readElementText();
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+
+    return apn;
+}
+
+void MobileProviders::readName(QXmlStreamReader &xml, QMap<QString, QString> &names)
+{
+    QString lang = xml.attributes().value(QLatin1String("xml:lang")).toString();
+    if (lang.isEmpty()) {
+        lang = "en";     // English is default
+    } else {
+        lang = lang.toLower();
+        // Remove everything after '-' in xml:lang attribute.
+        const int idx = lang.indexOf(QLatin1Char('-'));
+        if (idx != -1) {
+            lang.truncate(idx);
+        }
+    }
+    names.insert(lang, xml.readElementText());
+}
+
+QHash<QString, MobileProviders::NetworkIdProviders> MobileProviders::networkIndex(const QHash<QString, ProviderList> &providers)
+{
+    QHash<QString, NetworkIdProviders> index;
+    for (auto it = providers.constBegin(); it != providers.constEnd(); ++it) {
+        for (int i = 0; i < it.value().size(); ++i) {
+            for (const QString &networkId : it.value().at(i).networkIds) {
+                index[networkId] << qMakePair(it.key(), qint32(i));
+            }
+        }
+    }
+    return index;
+}
+
+QString MobileProviders::networkIdKey(const QString &networkId)
+{
+    // Operator codes are the MCC (always 3 digits) followed by a 2 or 3 digit MNC
+    if (!networkId.contains(QLatin1Char('-')) && (networkId.size() == 5 || networkId.size() == 6)) {
+        return networkId.left(3) + QLatin1Char('-') + networkId.mid(3);
+    }
+    return networkId;
+}
+
+bool MobileProviders::loadCache(const QFileInfo &providersInfo)
+{
+    mCacheFile.setFileName(cacheFilePath());
+    if (!mCacheFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = mCacheFile.size();
+    mCacheData = mCacheFile.map(0, size);
+    if (!mCacheData) {
+        mCacheFile.close();
+        return false;
+    }
+
+    QDataStream stream(QByteArray::fromRawData(reinterpret_cast<const char *>(mCacheData), size));
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString providersFile;
+    qint64 modified = 0;
+    qint64 providersSize = 0;
+    stream >> magic >> version;
+    if (magic == MOBILE_PROVIDERS_CACHE_MAGIC && version == MOBILE_PROVIDERS_CACHE_VERSION) {
+        stream >> providersFile >> modified >> providersSize >> mCacheIndex >> mNetworkIndex;
+    }
+
+    if (stream.status() != QDataStream::Ok
+        || magic != MOBILE_PROVIDERS_CACHE_MAGIC
+        || version != MOBILE_PROVIDERS_CACHE_VERSION
+        || providersFile != providersInfo.absoluteFilePath()
+        || modified != providersInfo.lastModified().toMSecsSinceEpoch()
+        || providersSize != providersInfo.size()) {
+        closeCache();
+        return false;
+    }
+
+    mCacheDataStart = stream.device()->pos();
+    return true;
+}
+
+void MobileProviders::closeCache()
+{
+    if (mCacheData) {
+        mCacheFile.unmap(const_cast<uchar *>(mCacheData));
+        mCacheData = nullptr;
+    }
+    mCacheFile.close();
+    mCacheIndex.clear();
+    mNetworkIndex.clear();
+}
+
+void MobileProviders::writeCache(const QHash<QString, ProviderList> &providers, const QFileInfo &providersInfo) const
+{
+    QByteArray data;
+    QHash<QString, QPair<qint64, qint64>> index;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_6);
+        for (auto it = providers.constBegin(); it != providers.constEnd(); ++it) {
+            const qint64 start = data.size();
+            writeProviders(stream, it.value());
+            index.insert(it.key(), qMakePair(start, data.size() - start));
+        }
+    }
+
+    const QString path = cacheFilePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(PLASMA_NM) << "Failed to write mobile providers cache" << path;
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << quint32(MOBILE_PROVIDERS_CACHE_MAGIC) << quint32(MOBILE_PROVIDERS_CACHE_VERSION)
+           << providersInfo.absoluteFilePath() << qint64(providersInfo.lastModified().toMSecsSinceEpoch()) << qint64(providersInfo.size())
+           << index << mNetworkIndex;
+    stream.writeRawData(data.constData(), data.size());
+
+    if (!file.commit()) {
+        qCWarning(PLASMA_NM) << "Failed to write mobile providers cache" << path;
+    }
+}
+
+void MobileProviders::writeProviders(QDataStream &stream, const ProviderList &providers)
+{
+    stream << qint32(providers.size());
+    for (const ProviderEntry &provider : providers) {
+        stream << provider.names << provider.gsm << provider.cdma << provider.networkIds
+               << provider.cdmaUsername << provider.cdmaPassword << provider.sids;
+        stream << qint32(provider.apns.size());
+        for (const ApnEntry &apn : provider.apns) {
+            stream << apn.apn << apn.names << apn.username << apn.password << apn.dns;
+        }
+    }
+}
+
+void MobileProviders::readProviders(QDataStream &stream, ProviderList &providers)
+{
+    // Counts come from a file, every entry takes at least one byte so don't trust
+    // more of them than there is data left
+    qint32 count = 0;
+    stream >> count;
+    if (count < 0 || count > stream.device()->bytesAvailable()) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return;
+    }
+    providers.reserve(count);
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        ProviderEntry provider;
+        stream >> provider.names >> provider.gsm >> provider.cdma >> provider.networkIds
+               >> provider.cdmaUsername >> provider.cdmaPassword >> provider.sids;
+
+        qint32 apnCount = 0;
+        stream >> apnCount;
+        if (apnCount < 0 || apnCount > stream.device()->bytesAvailable()) {
+            stream.setStatus(QDataStream::ReadCorruptData);
+            return;
+        }
+        provider.apns.reserve(apnCount);
+        for (qint32 j = 0; j < apnCount && stream.status() == QDataStream::Ok; ++j) {
+            ApnEntry apn;
+            stream >> apn.apn >> apn.names >> apn.username >> apn.password >> apn.dns;
+            provider.apns << apn;
+        }
+
+        providers << provider;
+    }
+}
+
+MobileProviders::ProviderList MobileProviders::providersForCountry(const QString &countryCode)
+{
+    auto it = mProviders.constFind(countryCode);
+    if (it != mProviders.constEnd()) {
+        return it.value();
+    }
+
+    ProviderList providers;
+    const QPair<qint64, qint64> entry = mCacheIndex.value(countryCode, qMakePair(qint64(-1), qint64(0)));
+    if (mCacheData && entry.first >= 0 && mCacheDataStart + entry.first + entry.second <= mCacheFile.size()) {
+        QDataStream stream(QByteArray::fromRawData(reinterpret_cast<const char *>(mCacheData + mCacheDataStart + entry.first), entry.second));
+        stream.setVersion(QDataStream::Qt_5_6);
+        readProviders(stream, providers);
+        if (stream.status() != QDataStream::Ok) {
+            // Same as a cache miss, read everything from the providers file and write a new cache
+            qCWarning(PLASMA_NM) << "Corrupted mobile providers cache" << cacheFilePath();
+            closeCache();
+
+            QHash<QString, ProviderList> allProviders;
+            if (parseProviders(allProviders)) {
+                mNetworkIndex = networkIndex(allProviders);
+                writeCache(allProviders, QFileInfo(mProvidersFile));
+                mProviders = allProviders;
+            }
+            return mProviders.value(countryCode);
+        }
+    }
+
+    mProviders.insert(countryCode, providers);
+    return providers;
+}
+
 QString MobileProviders::getNameByLocale(const QMap<QString, QString> &localizedNames) const
 {
     QString name;
@@ -21,14 +21,27 @@
 #ifndef PLASMA_NM_MOBILE_PROVIDERS_H
 #define PLASMA_NM_MOBILE_PROVIDERS_H
 
-#include <QStringList>
+#include <QFile>
 #include <QHash>
-#include <QDomDocument>
+#include <QMap>
+#include <QStringList>
 #include <QVariantMap>
+#include <QVector>
 
 #include <NetworkManagerQt/ConnectionSettings>
 
-class MobileProviders
+class QDataStream;
+class QFileInfo;
+class QXmlStreamReader;
+
+/**
+ * Access to the mobile broadband provider database.
+ *
+ * The XML database is parsed once and stored in a binary cache, later
+ * instances only map the cache and read the countries they are asked for.
+ * Providers can also be looked up directly by the network they operate.
+ */
+class Q_DECL_EXPORT MobileProviders
 {
 public:
     static const QString ProvidersFile;
@@ -36,8 +49,14 @@ public:
     enum ErrorCodes { Success, CountryCodesMissing, ProvidersMissing, ProvidersIsNull, ProvidersWrongFormat, ProvidersFormatNotSupported };
 
     MobileProviders();
+    explicit MobileProviders(const QString &providersFile);
     ~MobileProviders();
 
+    /**
+     * Returns where the parsed provider database is cached
+     */
+    static QString cacheFilePath();
+
     QStringList getCountryList() const;
     QString countryFromLocale() const;
     QString getCountryName(const QString & key) const { return mCountries.value(key); }
@@ -46,19 +65,78 @@ public:
     QStringList getNetworkIds(const QString & provider);
     QVariantMap getApnInfo(const QString & apn);
     QVariantMap getCdmaInfo(const QString & provider);
+    /**
+     * Returns the internet APN (same keys as getApnInfo() plus "provider" and "country") of the
+     * provider operating @networkId, given either as "mcc-mnc" or as the operator code reported by
+     * the modem. @spn is the service provider name from the SIM card, it picks the provider when
+     * several of them share the network. Returns an empty map for unknown networks.
+     */
+    QVariantMap getApnInfoByNetworkId(const QString &networkId, const QString &spn = QString());
     QString getGsmNumber() const { return QString("*99#"); }
     QString getCdmaNumber() const { return QString("#777"); }
     inline ErrorCodes getError() { return mError; }
 
 private:
+    struct ApnEntry {
+        QString apn;
+        QMap<QString, QString> names;
+        QString username;
+        QString password;
+        QStringList dns;
+    };
+
+    struct ProviderEntry {
+        QMap<QString, QString> names;
+        bool gsm = false;
+        bool cdma = false;
+        // Only APNs usable for internet access
+        QVector<ApnEntry> apns;
+        QStringList networkIds;
+        QString cdmaUsername;
+        QString cdmaPassword;
+        QStringList sids;
+    };
+
+    typedef QVector<ProviderEntry> ProviderList;
+    // Country code and position in the country's ProviderList
+    typedef QVector<QPair<QString, qint32>> NetworkIdProviders;
+
+    bool parseProviders(QHash<QString, ProviderList> &providers);
+    static ProviderEntry readProvider(QXmlStreamReader &xml);
+    static ApnEntry readApn(QXmlStreamReader &xml, bool *internet);
+    static void readName(QXmlStreamReader &xml, QMap<QString, QString> &names);
+    static QHash<QString, NetworkIdProviders> networkIndex(const QHash<QString, ProviderList> &providers);
+    static QString networkIdKey(const QString &networkId);
+
+    bool loadCache(const QFileInfo &providersInfo);
+    void closeCache();
+    void writeCache(const QHash<QString, ProviderList> &providers, const QFileInfo &providersInfo) const;
+    static void writeProviders(QDataStream &stream, const ProviderList &providers);
+    static void readProviders(QDataStream &stream, ProviderList &providers);
+    /**
+     * Returns providers of the country with given upper case code, reading them from the cache when needed
+     */
+    ProviderList providersForCountry(const QString &countryCode);
+    QVariantMap apnInfo(const ApnEntry &apn) const;
+
     QHash<QString, QString> mCountries;
-    QMap<QString, QDomNode> mProvidersGsm;
-    QMap<QString, QDomNode> mProvidersCdma;
-    QMap<QString, QDomNode> mApns;
+    QMap<QString, ProviderEntry> mProvidersGsm;
+    QMap<QString, ProviderEntry> mProvidersCdma;
+    QMap<QString, ApnEntry> mApns;
     QStringList mNetworkIds;
-    QDomDocument mDocProviders;
-    QDomElement docElement;
     ErrorCodes mError;
+    QString mProvidersFile;
+
+    // Providers of the countries already read, keyed by upper case country code
+    QHash<QString, ProviderList> mProviders;
+    // Position and size of each country in the mapped cache
+    QHash<QString, QPair<qint64, qint64>> mCacheIndex;
+    // Providers by "mcc-mnc" of their networks
+    QHash<QString, NetworkIdProviders> mNetworkIndex;
+    QFile mCacheFile;
+    const uchar *mCacheData = nullptr;
+    qint64 mCacheDataStart = 0;
+
     QString getNameByLocale(const QMap<QString, QString> & names) const;
 };
 
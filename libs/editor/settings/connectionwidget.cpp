@@ -19,6 +19,8 @@
 */
 
 #include "connectionwidget.h"
+#include "connectionsindex.h"
+#include "firewallzones.h"
 #include "ui_connectionwidget.h"
 #include "advancedpermissionswidget.h"
 
@@ -26,8 +28,9 @@
 #include <NetworkManagerQt/Connection>
 #include <NetworkManagerQt/ConnectionSettings>
 
-#include <QDBusConnection>
 #include <QDialog>
+#include <QLineEdit>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QDialogButtonBox>
 #include <KUser>
@@ -39,14 +42,24 @@ ConnectionWidget::ConnectionWidget(const NetworkManager::ConnectionSettings::Ptr
     m_widget(new Ui::ConnectionWidget),
     m_type(settings->connectionType()),
     m_masterUuid(settings->master()),
-    m_slaveType(settings->slaveType())
+    m_slaveType(settings->slaveType()),
+    m_vpnPopulated(false)
 {
     m_widget->setupUi(this);
 
-    m_widget->firewallZone->addItems(firewallZones());
+    // Zones are filled in whenever FirewallD answers, never wait for it here
+    FirewallZones *firewallZones = FirewallZones::self();
+    if (firewallZones->isReady()) {
+        updateFirewallZones(firewallZones->zones());
+    } else {
+        m_widget->firewallZone->lineEdit()->setPlaceholderText(i18n("Loading firewall zones…"));
+    }
+    connect(firewallZones, &FirewallZones::zonesChanged, this, &ConnectionWidget::updateFirewallZones);
 
-    // VPN combo
-    populateVpnConnections();
+    // VPN combo, filled once the editor is up and kept up to date afterwards
+    m_widget->vpnCombobox->addItem(i18n("Loading VPN connections…"));
+    QTimer::singleShot(0, this, &ConnectionWidget::populateVpnConnections);
+    connect(ConnectionsIndex::self(), &ConnectionsIndex::indexChanged, this, &ConnectionWidget::populateVpnConnections);
     if (settings->connectionType() == NetworkManager::ConnectionSettings::Vpn) {
         m_widget->autoconnectVpn->setEnabled(false);
         m_widget->vpnCombobox->setEnabled(false);
@@ -93,23 +106,29 @@ void ConnectionWidget::loadConfig(const NetworkManager::ConnectionSettings::Ptr
         m_widget->allUsers->setChecked(false);
     }
 
+    // Keep the zone even when FirewallD doesn't know it (yet)
     const QString zone = settings->zone();
-    m_widget->firewallZone->setCurrentIndex(m_widget->firewallZone->findText(zone));
-
-    const QStringList secondaries = settings->secondaries();
-    const QStringList vpnKeys = vpnConnections().keys();
-    if (!secondaries.isEmpty() && !vpnKeys.isEmpty()) {
-        for (const QString &vpnKey : vpnKeys) {
-            if (secondaries.contains(vpnKey)) {
-                m_widget->vpnCombobox->setCurrentIndex(m_widget->vpnCombobox->findData(vpnKey));
-                m_widget->autoconnectVpn->setChecked(true);
-                break;
-            }
-        }
+    const int zoneIndex = m_widget->firewallZone->findText(zone);
+    if (zoneIndex != -1) {
+        m_widget->firewallZone->setCurrentIndex(zoneIndex);
     } else {
-        m_widget->autoconnectVpn->setChecked(false);
+        m_widget->firewallZone->setEditText(zone);
     }
 
+    m_secondaryVpn.clear();
+    for (const QString &uuid : settings->secondaries()) {
+        NetworkManager::Connection::Ptr connection = ConnectionsIndex::self()->connectionByUuid(uuid);
+        if (connection && (connection->settings()->connectionType() == NetworkManager::ConnectionSettings::Vpn ||
+                           connection->settings()->connectionType() == NetworkManager::ConnectionSettings::WireGuard)) {
+            m_secondaryVpn = uuid;
+            break;
+        }
+    }
+    if (m_vpnPopulated && !m_secondaryVpn.isEmpty()) {
+        m_widget->vpnCombobox->setCurrentIndex(m_widget->vpnCombobox->findData(m_secondaryVpn));
+    }
+    m_widget->autoconnectVpn->setChecked(!m_secondaryVpn.isEmpty());
+
     m_widget->autoconnect->setChecked(settings->autoconnect());
 
     if (m_widget->prioritySpin->isEnabled()) {
@@ -138,8 +157,12 @@ NMVariantMapMap ConnectionWidget::setting() const
         }
     }
 
-    if (m_widget->autoconnectVpn->isChecked() && m_widget->vpnCombobox->count() > 0) {
-        settings.setSecondaries(QStringList() << m_widget->vpnCombobox->itemData(m_widget->vpnCombobox->currentIndex()).toString());
+    if (m_widget->autoconnectVpn->isChecked()) {
+        // Until the VPN list is there the configured one is still selected
+        const QString vpn = m_vpnPopulated ? m_widget->vpnCombobox->currentData().toString() : m_secondaryVpn;
+        if (!vpn.isEmpty()) {
+            settings.setSecondaries(QStringList() << vpn);
+        }
     }
 
     const QString zone = m_widget->firewallZone->currentText();
@@ -174,38 +197,52 @@ void ConnectionWidget::openAdvancedPermissions()
 
 NMStringMap ConnectionWidget::vpnConnections() const
 {
-    NetworkManager::Connection::List list = NetworkManager::listConnections();
+    NetworkManager::Connection::List list = ConnectionsIndex::self()->connections(NetworkManager::ConnectionSettings::Vpn);
+    list << ConnectionsIndex::self()->connections(NetworkManager::ConnectionSettings::WireGuard);
     NMStringMap result;
 
-    for (const NetworkManager::Connection::Ptr &conn : list) {
+    for (const NetworkManager::Connection::Ptr &conn : qAsConst(list)) {
         NetworkManager::ConnectionSettings::Ptr conSet = conn->settings();
-        if (conSet->connectionType() == NetworkManager::ConnectionSettings::Vpn
-            || conSet->connectionType() == NetworkManager::ConnectionSettings::WireGuard) {
-            // qCDebug(PLASMA_NM) << "Found VPN" << conSet->id() << conSet->uuid();
-            result.insert(conSet->uuid(), conSet->id());
-        }
+        // qCDebug(PLASMA_NM) << "Found VPN" << conSet->id() << conSet->uuid();
+        result.insert(conSet->uuid(), conSet->id());
     }
 
     return result;
 }
 
-QStringList ConnectionWidget::firewallZones() const
+void ConnectionWidget::updateFirewallZones(const QStringList &zones)
 {
-    QDBusMessage msg = QDBusMessage::createMethodCall("org.fedoraproject.FirewallD1", "/org/fedoraproject/FirewallD1", "org.fedoraproject.FirewallD1.zone",
-                                                      "getZones");
-    QDBusPendingReply<QStringList> reply = QDBusConnection::systemBus().asyncCall(msg);
-    reply.waitForFinished();
-    if (reply.isValid())
-        return reply.value();
-
-    return QStringList();
+    // Update in place, the zone being shown must not change nor count as user change
+    const QSignalBlocker blocker(m_widget->firewallZone);
+    const QString zone = m_widget->firewallZone->currentText();
+
+    m_widget->firewallZone->clear();
+    m_widget->firewallZone->addItems(zones);
+    m_widget->firewallZone->lineEdit()->setPlaceholderText(QString());
+
+    const int zoneIndex = m_widget->firewallZone->findText(zone);
+    if (zoneIndex != -1) {
+        m_widget->firewallZone->setCurrentIndex(zoneIndex);
+    } else {
+        m_widget->firewallZone->setEditText(zone);
+    }
 }
 
 void ConnectionWidget::populateVpnConnections()
 {
+    const QSignalBlocker blocker(m_widget->vpnCombobox);
+    const QString selected = m_vpnPopulated ? m_widget->vpnCombobox->currentData().toString() : m_secondaryVpn;
+
+    m_widget->vpnCombobox->clear();
     QMapIterator<QString,QString> it(vpnConnections());
     while (it.hasNext()) {
         it.next();
         m_widget->vpnCombobox->addItem(it.value(), it.key());
     }
+
+    const int index = m_widget->vpnCombobox->findData(selected);
+    if (index != -1) {
+        m_widget->vpnCombobox->setCurrentIndex(index);
+    }
+    m_vpnPopulated = true;
 }
@@ -46,6 +46,8 @@ public:
 private Q_SLOTS:
     void autoVpnToggled(bool on);
     void openAdvancedPermissions();
+    void updateFirewallZones(const QStringList &zones);
+    void populateVpnConnections();
 
 Q_SIGNALS:
     void settingChanged();
@@ -53,15 +55,15 @@ Q_SIGNALS:
 private:
     // list of VPN: UUID, name
     NMStringMap vpnConnections() const;
-    // list of firewalld zones
-    QStringList firewallZones() const;
 
-    void populateVpnConnections();
     Ui::ConnectionWidget * m_widget;
     NetworkManager::ConnectionSettings m_tmpSetting;
     NetworkManager::ConnectionSettings::ConnectionType m_type;
     QString m_masterUuid;
     QString m_slaveType;
+    // VPN to bring up together with the connection, as configured
+    QString m_secondaryVpn;
+    bool m_vpnPopulated;
 };
 
 #endif // PLASMA_NM_CONNECTION_WIDGET_H
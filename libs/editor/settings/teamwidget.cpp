@@ -21,6 +21,7 @@
 #include "teamwidget.h"
 #include "ui_team.h"
 #include "connectioneditordialog.h"
+#include "connectionsindex.h"
 #include "debug.h"
 
 #include <QDesktopServices>
@@ -216,14 +217,16 @@ void TeamWidget::populateTeams()
 {
     m_ui->teams->clear();
 
-    for (const NetworkManager::Connection::Ptr &connection : NetworkManager::listConnections()) {
+    // The mapping from slave to master may be by uuid or name, try our best to
+    // figure out if we are master to the slave.
+    NetworkManager::Connection::List slaves = ConnectionsIndex::self()->slaves(m_uuid);
+    if (!m_id.isEmpty() && m_id != m_uuid) {
+        slaves << ConnectionsIndex::self()->slaves(m_id);
+    }
+
+    for (const NetworkManager::Connection::Ptr &connection : qAsConst(slaves)) {
         NetworkManager::ConnectionSettings::Ptr settings = connection->settings();
-        // The mapping from slave to master may be by uuid or name, try our best to
-        // figure out if we are master to the slave.
-        const QString master = settings->master();
-        bool isSlave = ((master == m_uuid) || // by-uuid
-                        (!m_id.isEmpty() && master == m_id)); // by-name
-        if (isSlave && (settings->slaveType() == type())) {
+        if (settings->slaveType() == type()) {
             const QString label = QString("%1 (%2)").arg(connection->name()).arg(connection->settings()->typeAsString(connection->settings()->connectionType()));
             QListWidgetItem * slaveItem = new QListWidgetItem(label, m_ui->teams);
             slaveItem->setData(Qt::UserRole, connection->uuid());
@@ -19,6 +19,7 @@
 */
 
 #include "vlanwidget.h"
+#include "connectionsindex.h"
 #include "ui_vlan.h"
 #include "uiutils.h"
 
@@ -94,8 +95,8 @@ void VlanWidget::fillConnections()
 {
     m_ui->parent->clear();
 
-    for (const NetworkManager::Connection::Ptr &con : NetworkManager::listConnections()) {
-        if (!con->settings()->isSlave() && con->settings()->connectionType() == NetworkManager::ConnectionSettings::Wired)
+    for (const NetworkManager::Connection::Ptr &con : ConnectionsIndex::self()->connections(NetworkManager::ConnectionSettings::Wired)) {
+        if (!con->settings()->isSlave())
             m_ui->parent->addItem(con->name(), con->uuid());
     }
 }
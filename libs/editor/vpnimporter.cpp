@@ -0,0 +1,355 @@
+/*
+    Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "vpnimporter.h"
+
+#include "debug.h"
+#include "settings/wireguardinterfacewidget.h"
+#include "vpnuiplugin.h"
+
+#include <NetworkManagerQt/ConnectionSettings>
+#include <NetworkManagerQt/Settings>
+
+#include <KLocalizedString>
+#include <KService>
+#include <KServiceTypeTrader>
+
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+#include <QtConcurrent>
+
+// NetworkManager writes every new profile to disk, don't flood it with the whole batch at once
+static const int MaxPendingAdds = 4;
+
+struct VpnImporter::Job {
+    ~Job()
+    {
+        qDeleteAll(plugins);
+    }
+
+    QString fileName;
+    // Set when another file of the batch has the same base name
+    QString connectionName;
+    bool wireGuard = false;
+    // Every job has its own plugin instances, as plugins keep the result of the last import
+    QList<VpnUiPlugin *> plugins;
+    QList<QVariantMap> options;
+    // Plugins without batch import, they are tried on the GUI thread
+    QList<VpnUiPlugin *> interactive;
+    NMVariantMapMap connection;
+    QString error;
+    QStringList warnings;
+};
+
+struct PluginInfo {
+    KService::Ptr service;
+    QStringList extensions;
+};
+
+static QList<PluginInfo> vpnPlugins()
+{
+    QList<PluginInfo> plugins;
+
+    const KService::List services = KServiceTypeTrader::self()->query(QStringLiteral("PlasmaNetworkManagement/VpnUiPlugin"));
+    for (const KService::Ptr &service : services) {
+        VpnUiPlugin *vpnPlugin = service->createInstance<VpnUiPlugin>();
+        if (vpnPlugin) {
+            plugins << PluginInfo { service, vpnPlugin->supportedFileExtensions().split(QLatin1Char(' '), Qt::SkipEmptyParts) };
+            delete vpnPlugin;
+        }
+    }
+
+    return plugins;
+}
+
+VpnImporter::VpnImporter(QObject *parent)
+    : QObject(parent)
+    , m_watcher(new QFutureWatcher<Job *>(this))
+    , m_pendingAdds(0)
+    , m_done(0)
+    , m_total(0)
+{
+    connect(m_watcher, &QFutureWatcher<Job *>::resultReadyAt, this, &VpnImporter::fileParsed);
+}
+
+VpnImporter::~VpnImporter()
+{
+    m_watcher->cancel();
+    m_watcher->waitForFinished();
+    qDeleteAll(m_jobs);
+}
+
+QString VpnImporter::supportedFileExtensions()
+{
+    QStringList extensions = WireGuardInterfaceWidget::supportedFileExtensions().split(QLatin1Char(' '), Qt::SkipEmptyParts);
+    for (const PluginInfo &plugin : vpnPlugins()) {
+        extensions << plugin.extensions;
+    }
+    extensions.removeDuplicates();
+
+    return extensions.join(QLatin1Char(' '));
+}
+
+void VpnImporter::import(const QStringList &paths, QWidget *parent)
+{
+    if (isRunning()) {
+        qCWarning(PLASMA_NM) << "VPN import is already running";
+        return;
+    }
+
+    const QList<PluginInfo> plugins = vpnPlugins();
+    const QStringList wireGuardExtensions = WireGuardInterfaceWidget::supportedFileExtensions().split(QLatin1Char(' '), Qt::SkipEmptyParts);
+
+    QStringList nameFilters = wireGuardExtensions;
+    for (const PluginInfo &plugin : plugins) {
+        nameFilters << plugin.extensions;
+    }
+
+    QStringList fileNames;
+    for (const QString &path : paths) {
+        const QFileInfo fi(path);
+        if (fi.isDir()) {
+            for (const QFileInfo &entry : QDir(path).entryInfoList(nameFilters, QDir::Files | QDir::Readable, QDir::Name)) {
+                fileNames << entry.absoluteFilePath();
+            }
+        } else {
+            fileNames << fi.absoluteFilePath();
+        }
+    }
+    fileNames.removeDuplicates();
+
+    if (fileNames.isEmpty()) {
+        Q_EMIT finished();
+        return;
+    }
+
+    // Ask the questions now, only for plugins which are going to be used
+    QHash<int, QVariantMap> options;
+    QSet<QString> connectionNames;
+    for (const QString &fileName : qAsConst(fileNames)) {
+        const QString ext = QStringLiteral("*.") + QFileInfo(fileName).suffix();
+
+        Job *job = new Job;
+        job->fileName = fileName;
+
+        // Files are parsed at the same time, those with the same name from different directories
+        // would write their inline certificates to the same place
+        const QString baseName = QFileInfo(fileName).completeBaseName();
+        QString connectionName = baseName;
+        for (int i = 2; connectionNames.contains(connectionName); ++i) {
+            connectionName = baseName + QStringLiteral(" (%1)").arg(i);
+        }
+        connectionNames.insert(connectionName);
+        if (connectionName != baseName) {
+            job->connectionName = connectionName;
+        }
+
+        job->wireGuard = wireGuardExtensions.contains(ext);
+        for (int i = 0; i < plugins.size(); ++i) {
+            if (!plugins.at(i).extensions.contains(ext)) {
+                continue;
+            }
+
+            VpnUiPlugin *vpnPlugin = plugins.at(i).service->createInstance<VpnUiPlugin>();
+            if (!vpnPlugin) {
+                continue;
+            }
+
+            if (!options.contains(i)) {
+                options.insert(i, vpnPlugin->askImportOptions(parent));
+            }
+
+            job->plugins << vpnPlugin;
+            job->options << options.value(i);
+        }
+
+        if (!job->wireGuard && job->plugins.isEmpty()) {
+            job->error = i18n("Unsupported file type");
+        }
+
+        m_jobs << job;
+    }
+
+    qCDebug(PLASMA_NM) << "Importing" << m_jobs.size() << "VPN connections";
+
+    m_done = 0;
+    m_total = m_jobs.size();
+    Q_EMIT progress(m_done, m_total);
+
+    m_watcher->setFuture(QtConcurrent::mapped(m_jobs, &VpnImporter::parse));
+}
+
+void VpnImporter::cancel()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    m_watcher->cancel();
+    m_watcher->waitForFinished();
+    m_addQueue.clear();
+
+    // Only wait for the connections NetworkManager is already working on
+    m_total = m_done + m_pendingAdds;
+    if (m_done == m_total) {
+        finish();
+    }
+}
+
+bool VpnImporter::isRunning() const
+{
+    return !m_jobs.isEmpty();
+}
+
+VpnImporter::Job *VpnImporter::parse(Job *job)
+{
+    if (!job->error.isEmpty()) {
+        return job;
+    }
+
+    // Handle WireGuard first because it is different than all the other VPNs
+    if (job->wireGuard) {
+        job->connection = WireGuardInterfaceWidget::importConnectionSettings(job->fileName);
+        if (!job->connection.isEmpty()) {
+            return job;
+        }
+    }
+
+    for (int i = 0; i < job->plugins.size(); ++i) {
+        VpnUiPlugin *vpnPlugin = job->plugins.at(i);
+
+        QVariantMap options = job->options.at(i);
+        if (!job->connectionName.isEmpty()) {
+            options.insert(QStringLiteral("connectionName"), job->connectionName);
+        }
+
+        job->connection = vpnPlugin->batchImportConnectionSettings(job->fileName, options);
+        if (vpnPlugin->lastError() == VpnUiPlugin::NotImplemented) {
+            job->interactive << vpnPlugin;
+            continue;
+        }
+
+        if (!job->connection.isEmpty()) {
+            job->warnings = vpnPlugin->lastWarnings();
+            return job;
+        }
+
+        if (vpnPlugin->lastError() == VpnUiPlugin::Error) {
+            job->error = vpnPlugin->lastErrorMessage();
+        }
+    }
+
+    return job;
+}
+
+void VpnImporter::fileParsed(int index)
+{
+    if (m_watcher->isCanceled()) {
+        return;
+    }
+
+    Job *job = m_watcher->resultAt(index);
+
+    for (VpnUiPlugin *vpnPlugin : qAsConst(job->interactive)) {
+        if (!job->connection.isEmpty()) {
+            break;
+        }
+
+        job->connection = vpnPlugin->importConnectionSettings(job->fileName);
+        if (job->connection.isEmpty() && vpnPlugin->lastError() == VpnUiPlugin::Error) {
+            job->error = vpnPlugin->lastErrorMessage();
+        }
+    }
+
+    qDeleteAll(job->plugins);
+    job->plugins.clear();
+    job->interactive.clear();
+
+    if (job->connection.isEmpty()) {
+        Q_EMIT fileFailed(job->fileName, job->error.isEmpty() ? i18n("The file could not be imported") : job->error);
+        fileDone();
+        return;
+    }
+
+    NetworkManager::ConnectionSettings connectionSettings;
+    connectionSettings.fromMap(job->connection);
+    connectionSettings.setUuid(NetworkManager::ConnectionSettings::createNewUuid());
+    job->connection = connectionSettings.toMap();
+
+    m_addQueue.enqueue(job);
+    submit();
+}
+
+void VpnImporter::submit()
+{
+    while (m_pendingAdds < MaxPendingAdds && !m_addQueue.isEmpty()) {
+        Job *job = m_addQueue.dequeue();
+
+        QDBusPendingReply<QDBusObjectPath> reply = NetworkManager::addConnection(job->connection);
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
+        watcher->setProperty("fileName", job->fileName);
+        watcher->setProperty("warnings", job->warnings);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, &VpnImporter::addConnectionFinished);
+        ++m_pendingAdds;
+
+        // Imported connections can carry secrets, don't keep them around longer than needed
+        job->connection.clear();
+    }
+}
+
+void VpnImporter::addConnectionFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<QDBusObjectPath> reply = *watcher;
+    const QString fileName = watcher->property("fileName").toString();
+    --m_pendingAdds;
+
+    if (reply.isError()) {
+        qCWarning(PLASMA_NM) << "Failed to add imported connection" << fileName << reply.error().message();
+        Q_EMIT fileFailed(fileName, reply.error().message());
+    } else {
+        Q_EMIT fileImported(fileName, reply.value().path(), watcher->property("warnings").toStringList());
+    }
+
+    watcher->deleteLater();
+    fileDone();
+    submit();
+}
+
+void VpnImporter::fileDone()
+{
+    ++m_done;
+    Q_EMIT progress(m_done, m_total);
+
+    if (m_done == m_total) {
+        finish();
+    }
+}
+
+void VpnImporter::finish()
+{
+    qDeleteAll(m_jobs);
+    m_jobs.clear();
+    m_addQueue.clear();
+
+    Q_EMIT finished();
+}
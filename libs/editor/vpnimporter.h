@@ -0,0 +1,93 @@
+/*
+    Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLASMA_NM_VPN_IMPORTER_H
+#define PLASMA_NM_VPN_IMPORTER_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QQueue>
+#include <QStringList>
+
+class QDBusPendingCallWatcher;
+class QWidget;
+
+/**
+ * Imports a batch of VPN and WireGuard configuration files.
+ *
+ * Questions of the VPN plugins are asked once for the whole batch before any file is
+ * parsed, files are then parsed concurrently on worker threads and every connection is
+ * sent to NetworkManager as soon as its file is parsed, with a bounded number of
+ * AddConnection calls in flight.
+ */
+class Q_DECL_EXPORT VpnImporter : public QObject
+{
+    Q_OBJECT
+public:
+    explicit VpnImporter(QObject *parent = nullptr);
+    ~VpnImporter() override;
+
+    /**
+     * Name filters of all files which can be imported, in the format used by QFileDialog
+     */
+    static QString supportedFileExtensions();
+
+    /**
+     * Imports all @p paths, directories are searched (not recursively) for files
+     * with a supported extension. @p parent is used as parent of the questions.
+     */
+    void import(const QStringList &paths, QWidget *parent = nullptr);
+    /**
+     * Stops parsing, connections already sent to NetworkManager are still reported
+     */
+    void cancel();
+    bool isRunning() const;
+
+Q_SIGNALS:
+    void progress(int done, int total);
+    /**
+     * @connectionPath - D-Bus path of the new connection
+     * @warnings - non-fatal problems found in the file
+     */
+    void fileImported(const QString &fileName, const QString &connectionPath, const QStringList &warnings);
+    void fileFailed(const QString &fileName, const QString &error);
+    void finished();
+
+private Q_SLOTS:
+    void fileParsed(int index);
+    void addConnectionFinished(QDBusPendingCallWatcher *watcher);
+
+private:
+    struct Job;
+
+    static Job *parse(Job *job);
+    void submit();
+    void fileDone();
+    void finish();
+
+    QList<Job *> m_jobs;
+    QQueue<Job *> m_addQueue;
+    QFutureWatcher<Job *> *m_watcher;
+    int m_pendingAdds;
+    int m_done;
+    int m_total;
+};
+
+#endif // PLASMA_NM_VPN_IMPORTER_H
@@ -33,6 +33,22 @@ VpnUiPlugin::~VpnUiPlugin()
 {
 }
 
+QVariantMap VpnUiPlugin::askImportOptions(QWidget *parent)
+{
+    Q_UNUSED(parent);
+
+    return QVariantMap();
+}
+
+NMVariantMapMap VpnUiPlugin::batchImportConnectionSettings(const QString &fileName, const QVariantMap &options)
+{
+    Q_UNUSED(fileName);
+    Q_UNUSED(options);
+
+    mError = NotImplemented;
+    return NMVariantMapMap();
+}
+
 QMessageBox::StandardButtons VpnUiPlugin::suggestedAuthDialogButtons() const
 {
     return QMessageBox::Ok | QMessageBox::Cancel;
@@ -57,3 +73,8 @@ QString VpnUiPlugin::lastErrorMessage()
     }
     return mErrorMessage;
 }
+
+QStringList VpnUiPlugin::lastWarnings() const
+{
+    return mWarnings;
+}
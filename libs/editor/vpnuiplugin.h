@@ -64,14 +64,33 @@ public:
      * and mErrorMessage with a custom error message before returning an empty QVariantList.
      */
     virtual NMVariantMapMap importConnectionSettings(const QString &fileName) = 0;
+    /**
+     * Asks the user, once for a whole batch of files, the questions importConnectionSettings()
+     * would otherwise ask while parsing every single file. Called on the GUI thread, the returned
+     * answers are passed to batchImportConnectionSettings(). The default implementation has no questions.
+     */
+    virtual QVariantMap askImportOptions(QWidget *parent);
+    /**
+     * Same as importConnectionSettings(), but it must not interact with the user at all, so that
+     * several files can be parsed on worker threads at the same time. Non-fatal problems found
+     * in the file are reported through lastWarnings().
+     * Besides the answers from askImportOptions(), @p options may contain "connectionName", the name
+     * to use instead of the base name of @p fileName, so that files saved for connections imported
+     * together don't overwrite each other.
+     * The default implementation sets mError to VpnUiPlugin::NotImplemented, callers then have to
+     * fall back to importConnectionSettings() on the GUI thread.
+     */
+    virtual NMVariantMapMap batchImportConnectionSettings(const QString &fileName, const QVariantMap &options);
     virtual bool exportConnectionSettings(const NetworkManager::ConnectionSettings::Ptr &connection, const QString &fileName) = 0;
 
     virtual QMessageBox::StandardButtons suggestedAuthDialogButtons() const;
     ErrorType lastError() const;
     QString lastErrorMessage();
+    QStringList lastWarnings() const;
 protected:
     ErrorType mError;
     QString mErrorMessage;
+    QStringList mWarnings;
 };
 
 #endif // PLASMA_NM_VPN_UI_PLUGIN_H
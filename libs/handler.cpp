@@ -20,8 +20,10 @@
 */
 
 #include "handler.h"
+#include "bluetoothadaptercache.h"
 #include "connectioneditordialog.h"
 #include "configuration.h"
+#include "networkmodel.h"
 #include "uiutils.h"
 #include "debug.h"
 
@@ -47,9 +49,10 @@
 #include <ModemManagerQt/ModemDevice>
 #endif
 
+#include <QAbstractItemModel>
 #include <QDBusError>
-#include <QDBusMetaType>
 #include <QDBusPendingReply>
+#include <QElapsedTimer>
 #include <QIcon>
 
 #include <KNotification>
@@ -71,6 +74,7 @@ Handler::Handler(QObject *parent)
     : QObject(parent)
     , m_tmpWirelessEnabled(NetworkManager::isWirelessEnabled())
     , m_tmpWwanEnabled(NetworkManager::isWwanEnabled())
+    , m_bluetoothAdapterCache(nullptr)
     , m_isScanning(false)
 {
     QDBusConnection::sessionBus().connect(QStringLiteral(AGENT_SERVICE),
@@ -92,6 +96,12 @@ Handler::Handler(QObject *parent)
     if (NetworkManager::checkVersion(1, 16, 0)) {
         connect(NetworkManager::notifier(), &NetworkManager::Notifier::primaryConnectionTypeChanged, this, &Handler::primaryConnectionTypeChanged);
     }
+
+#if WITH_MODEMMANAGER_SUPPORT
+    connect(ModemManager::notifier(), &ModemManager::Notifier::modemRemoved, this, [this] () {
+        m_modemDevices.clear();
+    });
+#endif
 }
 
 Handler::~Handler()
@@ -100,6 +110,9 @@ Handler::~Handler()
 
 void Handler::activateConnection(const QString& connection, const QString& device, const QString& specificObject)
 {
+    QElapsedTimer requestTimer;
+    requestTimer.start();
+
     NetworkManager::Connection::Ptr con = NetworkManager::findConnection(connection);
 
     if (!con) {
@@ -112,23 +125,7 @@ void Handler::activateConnection(const QString& connection, const QString& devic
         if (vpnSetting) {
             qCDebug(PLASMA_NM) << "Checking VPN" << con->name() << "type:" << vpnSetting->serviceType();
 
-            bool pluginMissing = false;
-
-            // Check missing plasma-nm VPN plugin
-            const KService::List services = KServiceTypeTrader::self()->query("PlasmaNetworkManagement/VpnUiPlugin",
-                                                                              QString::fromLatin1("[X-NetworkManager-Services]=='%1'").arg(vpnSetting->serviceType()));
-            pluginMissing = services.isEmpty();
-
-            // Check missing NetworkManager VPN plugin
-            if (!pluginMissing) {
-                GSList *plugins = nullptr;
-                plugins = nm_vpn_plugin_info_list_load();
-
-                NMVpnPluginInfo *plugin_info = nm_vpn_plugin_info_list_find_by_service(plugins, vpnSetting->serviceType().toStdString().c_str());
-                pluginMissing = !plugin_info;
-            }
-
-            if (pluginMissing) {
+            if (!vpnPluginAvailable(vpnSetting->serviceType())) {
                 qCWarning(PLASMA_NM) << "VPN" << vpnSetting->serviceType() << "not found, skipping";
                 KNotification *notification = new KNotification("MissingVpnPlugin", KNotification::CloseOnTimeout, this);
                 notification->setComponentName("networkmanagement");
@@ -143,22 +140,19 @@ void Handler::activateConnection(const QString& connection, const QString& devic
 
 #if WITH_MODEMMANAGER_SUPPORT
     if (con->settings()->connectionType() == NetworkManager::ConnectionSettings::Gsm) {
-        NetworkManager::ModemDevice::Ptr nmModemDevice = NetworkManager::findNetworkInterface(device).objectCast<NetworkManager::ModemDevice>();
-        if (nmModemDevice) {
-            ModemManager::ModemDevice::Ptr mmModemDevice = ModemManager::findModemDevice(nmModemDevice->udi());
-            if (mmModemDevice) {
-                ModemManager::Modem::Ptr modem = mmModemDevice->interface(ModemManager::ModemDevice::ModemInterface).objectCast<ModemManager::Modem>();
-                NetworkManager::GsmSetting::Ptr gsmSetting = con->settings()->setting(NetworkManager::Setting::Gsm).staticCast<NetworkManager::GsmSetting>();
-                if (gsmSetting && gsmSetting->pinFlags() == NetworkManager::Setting::NotSaved &&
-                    modem && modem->unlockRequired() > MM_MODEM_LOCK_NONE) {
-                    QDBusInterface managerIface("org.kde.plasmanetworkmanagement", "/org/kde/plasmanetworkmanagement", "org.kde.plasmanetworkmanagement", QDBusConnection::sessionBus(), this);
-                    managerIface.call("unlockModem", mmModemDevice->uni());
-                    connect(modem.data(), &ModemManager::Modem::unlockRequiredChanged, this, &Handler::unlockRequiredChanged);
-                    m_tmpConnectionPath = connection;
-                    m_tmpDevicePath = device;
-                    m_tmpSpecificPath = specificObject;
-                    return;
-                }
+        ModemManager::ModemDevice::Ptr mmModemDevice = findModemDevice(device);
+        if (mmModemDevice) {
+            ModemManager::Modem::Ptr modem = mmModemDevice->interface(ModemManager::ModemDevice::ModemInterface).objectCast<ModemManager::Modem>();
+            NetworkManager::GsmSetting::Ptr gsmSetting = con->settings()->setting(NetworkManager::Setting::Gsm).staticCast<NetworkManager::GsmSetting>();
+            if (gsmSetting && gsmSetting->pinFlags() == NetworkManager::Setting::NotSaved &&
+                modem && modem->unlockRequired() > MM_MODEM_LOCK_NONE) {
+                QDBusInterface managerIface("org.kde.plasmanetworkmanagement", "/org/kde/plasmanetworkmanagement", "org.kde.plasmanetworkmanagement", QDBusConnection::sessionBus(), this);
+                managerIface.call("unlockModem", mmModemDevice->uni());
+                connect(modem.data(), &ModemManager::Modem::unlockRequiredChanged, this, &Handler::unlockRequiredChanged);
+                m_tmpConnectionPath = connection;
+                m_tmpDevicePath = device;
+                m_tmpSpecificPath = specificObject;
+                return;
             }
         }
     }
@@ -169,8 +163,104 @@ void Handler::activateConnection(const QString& connection, const QString& devic
     watcher->setProperty("action", Handler::ActivateConnection);
     watcher->setProperty("connection", con->name());
     connect(watcher, &QDBusPendingCallWatcher::finished, this, &Handler::replyFinished);
+
+    qCDebug(PLASMA_NM) << "Activation of" << con->name() << "requested after" << requestTimer.nsecsElapsed() / 1000 << "us";
 }
 
+void Handler::prefetchActivations(QAbstractItemModel *model, int count)
+{
+    if (!model) {
+        return;
+    }
+
+    QElapsedTimer prefetchTimer;
+    prefetchTimer.start();
+
+    // Plugins may have been (un)installed since the last time the popup was shown
+    m_vpnPluginAvailable.clear();
+#if WITH_MODEMMANAGER_SUPPORT
+    m_modemDevices.clear();
+#endif
+
+    const int rows = qMin(count, model->rowCount());
+    for (int row = 0; row < rows; ++row) {
+        const QModelIndex index = model->index(row, 0);
+        const QString connectionPath = model->data(index, NetworkModel::ConnectionPathRole).toString();
+        if (connectionPath.isEmpty()) {
+            continue;
+        }
+
+        NetworkManager::Connection::Ptr con = NetworkManager::findConnection(connectionPath);
+        if (!con) {
+            continue;
+        }
+
+        // Settings are parsed on first use and kept by the connection object
+        NetworkManager::ConnectionSettings::Ptr settings = con->settings();
+        if (settings->connectionType() == NetworkManager::ConnectionSettings::Vpn) {
+            NetworkManager::VpnSetting::Ptr vpnSetting = settings->setting(NetworkManager::Setting::Vpn).staticCast<NetworkManager::VpnSetting>();
+            if (vpnSetting) {
+                vpnPluginAvailable(vpnSetting->serviceType());
+            }
+        }
+#if WITH_MODEMMANAGER_SUPPORT
+        else if (settings->connectionType() == NetworkManager::ConnectionSettings::Gsm) {
+            findModemDevice(model->data(index, NetworkModel::DevicePathRole).toString());
+        }
+#endif
+    }
+
+    qCDebug(PLASMA_NM) << "Prefetched activation data for" << rows << "connections in" << prefetchTimer.elapsed() << "ms";
+}
+
+bool Handler::vpnPluginAvailable(const QString &serviceType)
+{
+    auto it = m_vpnPluginAvailable.constFind(serviceType);
+    if (it != m_vpnPluginAvailable.constEnd()) {
+        return it.value();
+    }
+
+    // Check missing plasma-nm VPN plugin
+    const KService::List services = KServiceTypeTrader::self()->query("PlasmaNetworkManagement/VpnUiPlugin",
+                                                                      QString::fromLatin1("[X-NetworkManager-Services]=='%1'").arg(serviceType));
+    bool available = !services.isEmpty();
+
+    // Check missing NetworkManager VPN plugin
+    if (available) {
+        GSList *plugins = nm_vpn_plugin_info_list_load();
+        NMVpnPluginInfo *plugin_info = nm_vpn_plugin_info_list_find_by_service(plugins, serviceType.toStdString().c_str());
+        available = plugin_info != nullptr;
+        g_slist_free_full(plugins, g_object_unref);
+    }
+
+    // A missing plugin can be installed while we are running, only remember the ones we found
+    if (available) {
+        m_vpnPluginAvailable.insert(serviceType, available);
+    }
+    return available;
+}
+
+#if WITH_MODEMMANAGER_SUPPORT
+ModemManager::ModemDevice::Ptr Handler::findModemDevice(const QString &device)
+{
+    auto it = m_modemDevices.constFind(device);
+    if (it != m_modemDevices.constEnd()) {
+        return it.value();
+    }
+
+    ModemManager::ModemDevice::Ptr mmModemDevice;
+    NetworkManager::ModemDevice::Ptr nmModemDevice = NetworkManager::findNetworkInterface(device).objectCast<NetworkManager::ModemDevice>();
+    if (nmModemDevice) {
+        mmModemDevice = ModemManager::findModemDevice(nmModemDevice->udi());
+        if (mmModemDevice) {
+            m_modemDevices.insert(device, mmModemDevice);
+        }
+    }
+
+    return mmModemDevice;
+}
+#endif
+
 QString Handler::wifiCode(const QString& connectionPath, const QString& ssid, int _securityType) const
 {
     NetworkManager::WirelessSecurityType securityType = static_cast<NetworkManager::WirelessSecurityType>(_securityType);
@@ -389,65 +479,39 @@ void Handler::enableAirplaneMode(bool enable)
     }
 }
 
-template<typename T>
-void makeDBusCall(const QDBusMessage &message, QObject *context, std::function<void(QDBusPendingReply<T>)> func)
-{
-    QDBusPendingReply<T> reply = QDBusConnection::systemBus().asyncCall(message);
-    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, context);
-    QObject::connect(watcher, &QDBusPendingCallWatcher::finished, context, [func] (QDBusPendingCallWatcher *watcher) {
-        const QDBusPendingReply<T> reply = *watcher;
-        if (!reply.isValid()) {
-            qCWarning(PLASMA_NM) << reply.error().message();
-            return;
-        }
-        func(reply);
-        watcher->deleteLater();
-    });
-}
-
-void setBluetoothEnabled(QString path, bool enabled)
-{
-    QDBusMessage message = QDBusMessage::createMethodCall("org.bluez", path, "org.freedesktop.DBus.Properties", "Set");
-    QList<QVariant> arguments;
-    arguments << QLatin1String("org.bluez.Adapter1");
-    arguments << QLatin1String("Powered");
-    arguments << QVariant::fromValue(QDBusVariant(QVariant(enabled)));
-    message.setArguments(arguments);
-    QDBusConnection::systemBus().asyncCall(message);
-}
-
 void Handler::enableBluetooth(bool enable)
 {
-    qDBusRegisterMetaType< QMap<QDBusObjectPath, NMVariantMapMap > >();
-
-    const QDBusMessage getObjects = QDBusMessage::createMethodCall("org.bluez", "/", "org.freedesktop.DBus.ObjectManager", "GetManagedObjects");
+    // Most users of Handler never touch Bluetooth, don't watch BlueZ until needed
+    if (!m_bluetoothAdapterCache) {
+        m_bluetoothAdapterCache = new BluetoothAdapterCache(this);
+    }
 
-    makeDBusCall<QMap<QDBusObjectPath, NMVariantMapMap>>(getObjects, this, [enable, this](const auto reply) {
-        for (const QDBusObjectPath &path : reply.value().keys()) {
-            const QString objPath = path.path();
-            qCDebug(PLASMA_NM) << "inspecting path" << objPath;
-            const QStringList interfaces = reply.value().value(path).keys();
-            qCDebug(PLASMA_NM) << "interfaces:" << interfaces;
+    if (!m_bluetoothAdapterCache->isReady()) {
+        // Initial GetManagedObjects is still pending, apply the change once we know the adapters
+        disconnect(m_bluetoothAdapterCacheReady);
+        m_bluetoothAdapterCacheReady = connect(m_bluetoothAdapterCache, &BluetoothAdapterCache::ready, this, [this, enable] () {
+            disconnect(m_bluetoothAdapterCacheReady);
+            enableBluetooth(enable);
+        });
+        return;
+    }
 
-            if (!interfaces.contains("org.bluez.Adapter1")) {
-                continue;
+    const QMap<QString, bool> adapters = m_bluetoothAdapterCache->adapters();
+    if (!enable) {
+        // Remember previous state so we can restore it when leaving airplane mode
+        m_bluetoothAdapters = adapters;
+        for (auto it = adapters.constBegin(); it != adapters.constEnd(); ++it) {
+            if (it.value()) {
+                m_bluetoothAdapterCache->setPowered(it.key(), false);
             }
-
-            // We need to check previous state first
-            if (!enable) {
-                QDBusMessage getPowered = QDBusMessage::createMethodCall("org.bluez", objPath, "org.freedesktop.DBus.Properties", "Get");
-                const QList<QVariant> arguments { QLatin1String("org.bluez.Adapter1"), QLatin1String("Powered") };
-                getPowered.setArguments(arguments);
-
-                makeDBusCall<QVariant>(getPowered, this, [objPath, this](const auto reply){
-                    m_bluetoothAdapters.insert(objPath, reply.value().toBool());
-                    setBluetoothEnabled(objPath, false);
-                });
-            } else if (m_bluetoothAdapters.value(objPath)) {
-                setBluetoothEnabled(objPath, true);
+        }
+    } else {
+        for (auto it = adapters.constBegin(); it != adapters.constEnd(); ++it) {
+            if (m_bluetoothAdapters.value(it.key()) && !it.value()) {
+                m_bluetoothAdapterCache->setPowered(it.key(), true);
             }
         }
-    });
+    }
 }
 
 void Handler::enableNetworking(bool enable)
@@ -31,8 +31,13 @@
 #include <NetworkManagerQt/Utils>
 #if WITH_MODEMMANAGER_SUPPORT
 #include <ModemManagerQt/GenericTypes>
+#include <ModemManagerQt/ModemDevice>
 #endif
 
+class QAbstractItemModel;
+
+class BluetoothAdapterCache;
+
 class Q_DECL_EXPORT Handler : public QObject
 {
 
@@ -70,6 +75,14 @@ public Q_SLOTS:
      * @specificParameter - d-bus path of the specific object you want to use for this activation, i.e access point
      */
     void activateConnection(const QString &connection, const QString &device, const QString &specificParameter);
+    /**
+     * Warms up everything activateConnection() needs for the first rows of given model
+     * (connection settings, VPN plugin availability, modem lookup), so that activating
+     * one of them only issues the D-Bus call
+     * @model - model with NetworkModel roles, typically the sorted applet model
+     * @count - number of rows from the top of the model to prepare
+     */
+    void prefetchActivations(QAbstractItemModel *model, int count);
     /**
      * Adds and activates a new wireless connection
      * @device - d-bus path of the wireless device where the connection should be activated
@@ -162,9 +175,20 @@ private:
     QString m_tmpDevicePath;
     QString m_tmpSpecificPath;
     QMap<QString, bool> m_bluetoothAdapters;
+    BluetoothAdapterCache *m_bluetoothAdapterCache;
+    QMetaObject::Connection m_bluetoothAdapterCacheReady;
     QMap<QString, QTimer*> m_wirelessScanRetryTimer;
 
+    QHash<QString, bool> m_vpnPluginAvailable;
+#if WITH_MODEMMANAGER_SUPPORT
+    QHash<QString, ModemManager::ModemDevice::Ptr> m_modemDevices;
+#endif
+
     void enableBluetooth(bool enable);
+    bool vpnPluginAvailable(const QString &serviceType);
+#if WITH_MODEMMANAGER_SUPPORT
+    ModemManager::ModemDevice::Ptr findModemDevice(const QString &device);
+#endif
     void scanRequestFailed(const QString &interface);
     bool checkRequestScanRateLimit(const NetworkManager::WirelessDevice::Ptr &wifiDevice);
     bool checkHotspotSupported();
@@ -237,6 +237,12 @@ CreatableConnectionsModel::CreatableConnectionsModel(QObject *parent)
                                                  NetworkManager::ConnectionSettings::Vpn,
                                                  QLatin1String("imported"), QLatin1String("imported"), false);
     m_list << connectionItem;
+
+    connectionItem = new CreatableConnectionItem(i18n("Import VPN connections from folder..."), i18n("Other"),
+                                                 i18n("Import all saved configuration files in a folder"), QStringLiteral("document-import"),
+                                                 NetworkManager::ConnectionSettings::Vpn,
+                                                 QLatin1String("importedFolder"), QLatin1String("importedFolder"), false);
+    m_list << connectionItem;
 }
 
 CreatableConnectionsModel::~CreatableConnectionsModel()
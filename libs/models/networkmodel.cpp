@@ -32,12 +32,18 @@
 #include <NetworkManagerQt/Settings>
 #include <NetworkManagerQt/Utils>
 
+#include <QTimer>
+
 
 NetworkModel::NetworkModel(QObject *parent)
     : QAbstractListModel(parent)
 {
     QLoggingCategory::setFilterRules(QStringLiteral("plasma-nm.debug = false"));
 
+    m_lastUsedTimer = new QTimer(this);
+    m_lastUsedTimer->setSingleShot(true);
+    connect(m_lastUsedTimer, &QTimer::timeout, this, &NetworkModel::refreshLastUsed);
+
     initialize();
 }
 
@@ -124,10 +130,16 @@ QVariant NetworkModel::data(const QModelIndex &index, int role) const
                 }
             case ItemTypeRole:
                 return item->itemType();
-            case LastUsedRole:
-                return UiUtils::formatLastUsedDateRelative(item->timestamp());
-            case LastUsedDateOnlyRole:
-                return UiUtils::formatDateRelative(item->timestamp());
+            case LastUsedRole: {
+                const QString lastUsed = item->lastUsed();
+                scheduleLastUsedRefresh(item->lastUsedExpiration());
+                return lastUsed;
+            }
+            case LastUsedDateOnlyRole: {
+                const QString lastUsed = item->lastUsedDateOnly();
+                scheduleLastUsedRefresh(item->lastUsedExpiration());
+                return lastUsed;
+            }
             case NameRole:
                 return item->name();
             case SectionRole:
@@ -663,6 +675,52 @@ void NetworkModel::updateItem(NetworkModelItem*item)
     }
 }
 
+void NetworkModel::scheduleLastUsedRefresh(const QDateTime &expiration) const
+{
+    if (!expiration.isValid()) {
+        return;
+    }
+
+    // Expirations are at most a day away, so this fits the timer interval
+    const int interval = qMax<qint64>(QDateTime::currentDateTime().msecsTo(expiration), 0);
+    if (!m_lastUsedTimer->isActive() || m_lastUsedTimer->remainingTime() > interval) {
+        m_lastUsedTimer->start(interval);
+    }
+}
+
+void NetworkModel::refreshLastUsed()
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    int firstRow = -1;
+    int lastRow = -1;
+    QDateTime nextExpiration;
+
+    for (int row = 0; row < m_list.count(); ++row) {
+        NetworkModelItem *item = m_list.itemAt(row);
+        const QDateTime expiration = item->lastUsedExpiration();
+        if (!expiration.isValid()) {
+            continue;
+        }
+
+        if (expiration <= now) {
+            item->invalidateLastUsed();
+            if (firstRow < 0) {
+                firstRow = row;
+            }
+            lastRow = row;
+        } else if (!nextExpiration.isValid() || expiration < nextExpiration) {
+            nextExpiration = expiration;
+        }
+    }
+
+    // Views ask for the texts again, which schedules the next refresh for the invalidated items
+    scheduleLastUsedRefresh(nextExpiration);
+
+    if (firstRow >= 0) {
+        Q_EMIT dataChanged(createIndex(firstRow, 0), createIndex(lastRow, 0), {LastUsedRole, LastUsedDateOnlyRole});
+    }
+}
+
 void NetworkModel::accessPointSignalStrengthChanged(int signal)
 {
     NetworkManager::AccessPoint *apPtr = qobject_cast<NetworkManager::AccessPoint*>(sender());
@@ -35,6 +35,8 @@
 #include <ModemManagerQt/modem.h>
 #endif
 
+class QTimer;
+
 class Q_DECL_EXPORT NetworkModel : public QAbstractListModel
 {
 Q_OBJECT
@@ -133,6 +135,7 @@ private Q_SLOTS:
     void wirelessNetworkDisappeared(const QString &ssid);
     void wirelessNetworkSignalChanged(int signal);
     void wirelessNetworkReferenceApChanged(const QString &accessPoint);
+    void refreshLastUsed();
 
     void initialize();
     
@@ -152,10 +155,16 @@ private:
     void initializeSignals(const NetworkManager::Device::Ptr &device);
     void initializeSignals(const NetworkManager::WirelessNetwork::Ptr &network);
     void updateItem(NetworkModelItem *item);
+    /**
+     * Makes sure the "last used" texts are refreshed no later than @expiration
+     */
+    void scheduleLastUsedRefresh(const QDateTime &expiration) const;
     void updateFromWirelessNetwork(NetworkModelItem *item, const NetworkManager::WirelessNetwork::Ptr &network, const NetworkManager::WirelessDevice::Ptr &device);
 
     NetworkManager::WirelessSecurityType alternativeWirelessSecurity(const NetworkManager::WirelessSecurityType type);
     bool m_isAllowUpdate = true;
+    // One timer for the whole model, it fires when the first cached "last used" text expires
+    QTimer *m_lastUsedTimer = nullptr;
 };
 
 #endif // PLASMA_NM_NETWORK_MODEL_H
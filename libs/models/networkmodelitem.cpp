@@ -427,7 +427,63 @@ void NetworkModelItem::setTimestamp(const QDateTime &date)
 {
     if (m_timestamp != date) {
         m_timestamp = date;
-        m_changedRoles << NetworkModel::TimeStampRole;
+        invalidateLastUsed();
+        m_changedRoles << NetworkModel::TimeStampRole << NetworkModel::LastUsedRole << NetworkModel::LastUsedDateOnlyRole;
+    }
+}
+
+QString NetworkModelItem::lastUsed() const
+{
+    if (!m_lastUsedValid) {
+        updateLastUsed();
+    }
+
+    return m_lastUsed;
+}
+
+QString NetworkModelItem::lastUsedDateOnly() const
+{
+    if (!m_lastUsedValid) {
+        updateLastUsed();
+    }
+
+    return m_lastUsedDateOnly;
+}
+
+void NetworkModelItem::invalidateLastUsed()
+{
+    m_lastUsedValid = false;
+    m_lastUsedExpiration = QDateTime();
+}
+
+void NetworkModelItem::updateLastUsed() const
+{
+    m_lastUsed = UiUtils::formatLastUsedDateRelative(m_timestamp);
+    m_lastUsedDateOnly = UiUtils::formatDateRelative(m_timestamp);
+    m_lastUsedValid = true;
+    m_lastUsedExpiration = QDateTime();
+
+    if (!m_timestamp.isValid()) {
+        return;
+    }
+
+    // Mirrors the steps used by UiUtils::formatDateRelative(), minutes during
+    // the first hour, then hours until midnight and "yesterday" for one more day
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDateTime midnight(now.date().addDays(1), QTime(0, 0));
+    const qint64 daysAgo = m_timestamp.daysTo(now);
+
+    if (daysAgo == 0) {
+        const qint64 secondsAgo = qMax<qint64>(m_timestamp.secsTo(now), 0);
+        QDateTime next;
+        if (secondsAgo < 60 * 60) {
+            next = m_timestamp.addSecs((secondsAgo / 60 + 1) * 60);
+        } else {
+            next = m_timestamp.addSecs((secondsAgo / (60 * 60) + 1) * 60 * 60);
+        }
+        m_lastUsedExpiration = qMin(next, midnight);
+    } else if (daysAgo == 1) {
+        m_lastUsedExpiration = midnight;
     }
 }
 
@@ -99,6 +99,18 @@ public:
     QDateTime timestamp() const;
     void setTimestamp(const QDateTime &date);
 
+    /**
+     * Relative "last used" texts, formatted once and kept until they expire
+     */
+    QString lastUsed() const;
+    QString lastUsedDateOnly() const;
+    /**
+     * Returns when the cached texts stop being correct, invalid when there
+     * is nothing cached or the texts never change
+     */
+    QDateTime lastUsedExpiration() const { return m_lastUsedExpiration; }
+    void invalidateLastUsed();
+
     NetworkManager::ConnectionSettings::ConnectionType type() const;
     void setType(NetworkManager::ConnectionSettings::ConnectionType type);
 
@@ -165,6 +177,7 @@ private:
     QString computeIcon() const;
     void refreshIcon();
     void updateDetails() const;
+    void updateLastUsed() const;
 
     QString m_activeConnectionPath;
     QString m_connectionPath;
@@ -183,6 +196,10 @@ private:
     QString m_specificPath;
     QString m_ssid;
     QDateTime m_timestamp;
+    mutable QString m_lastUsed;
+    mutable QString m_lastUsedDateOnly;
+    mutable QDateTime m_lastUsedExpiration;
+    mutable bool m_lastUsedValid = false;
     NetworkManager::ConnectionSettings::ConnectionType m_type;
     QString m_uuid;
     QString m_vpnType;
@@ -47,6 +47,9 @@
 #endif
 
 // Qt
+#include <QHash>
+#include <QLocale>
+#include <QMutex>
 #include <QSizeF>
 #include <QHostAddress>
 
@@ -54,6 +57,65 @@
 
 using namespace NetworkManager;
 
+namespace
+{
+// Every kind of label has its own key space in the LabelCache
+enum LabelKind {
+    InterfaceTypeLabel,
+    ModemTypeLabel,
+    DeviceStateLabel,
+    VpnStateLabel,
+    OperationModeLabel,
+    WirelessSecurityLabel,
+    AllowedModeLabel,
+    AccessTechnologyLabel,
+    LockReasonLabel
+};
+
+/**
+ * Translated labels for enum values. The models ask for the same few labels
+ * on every repaint and looking them up in the catalogs is not cheap, so each
+ * label is translated once and kept until the language or locale changes.
+ */
+class LabelCache
+{
+public:
+    template<typename Builder>
+    QString label(LabelKind kind, int value, Builder build)
+    {
+        // Both are implicitly shared, comparing them is cheap while nothing changed
+        const QStringList languages = KLocalizedString::languages();
+        const QLocale locale;
+
+        QMutexLocker locker(&m_mutex);
+        if (languages != m_languages || locale != m_locale) {
+            m_labels.clear();
+            m_languages = languages;
+            m_locale = locale;
+        }
+
+        const quint64 key = (quint64(kind) << 32) | quint32(value);
+        auto it = m_labels.constFind(key);
+        if (it != m_labels.constEnd()) {
+            return it.value();
+        }
+
+        const QString label = build();
+        m_labels.insert(key, label);
+        return label;
+    }
+
+private:
+    QMutex m_mutex;
+    // Language and locale the labels were translated for
+    QStringList m_languages;
+    QLocale m_locale;
+    QHash<quint64, QString> m_labels;
+};
+}
+
+Q_GLOBAL_STATIC(LabelCache, s_labelCache)
+
 UiUtils::SortedConnectionType UiUtils::connectionTypeToSortedType(NetworkManager::ConnectionSettings::ConnectionType type)
 {
     switch (type) {
@@ -143,7 +205,7 @@ bool UiUtils::isConnectionTypeVirtual(NetworkManager::ConnectionSettings::Connec
    return false;
 }
 
-QString UiUtils::interfaceTypeLabel(const NetworkManager::Device::Type type, const NetworkManager::Device::Ptr iface)
+static QString interfaceTypeText(NetworkManager::Device::Type type)
 {
     QString deviceText;
     switch (type) {
@@ -171,25 +233,6 @@ QString UiUtils::interfaceTypeLabel(const NetworkManager::Device::Type type, con
     case NetworkManager::Device::Team:
         deviceText = i18nc("title of the interface widget in nm's popup", "Virtual (team)");
         break;
-    case NetworkManager::Device::Modem: {
-        const NetworkManager::ModemDevice::Ptr nmModemIface = iface.objectCast<NetworkManager::ModemDevice>();
-        if (nmModemIface) {
-            switch(modemSubType(nmModemIface->currentCapabilities())) {
-            case NetworkManager::ModemDevice::Pots:
-                deviceText = i18nc("title of the interface widget in nm's popup", "Serial Modem");
-                break;
-            case NetworkManager::ModemDevice::GsmUmts:
-            case NetworkManager::ModemDevice::CdmaEvdo:
-            case NetworkManager::ModemDevice::Lte:
-                deviceText = i18nc("title of the interface widget in nm's popup", "Mobile Broadband");
-                break;
-            case NetworkManager::ModemDevice::NoCapability:
-                qCWarning(PLASMA_NM) << "Unhandled modem sub type: NetworkManager::ModemDevice::NoCapability";
-                break;
-            }
-        }
-    }
-        break;
     case NetworkManager::Device::Ethernet:
     default:
         deviceText = i18nc("title of the interface widget in nm's popup", "Wired Ethernet");
@@ -198,6 +241,44 @@ QString UiUtils::interfaceTypeLabel(const NetworkManager::Device::Type type, con
     return deviceText;
 }
 
+static QString modemTypeText(NetworkManager::ModemDevice::Capability modemType)
+{
+    QString deviceText;
+    switch (modemType) {
+    case NetworkManager::ModemDevice::Pots:
+        deviceText = i18nc("title of the interface widget in nm's popup", "Serial Modem");
+        break;
+    case NetworkManager::ModemDevice::GsmUmts:
+    case NetworkManager::ModemDevice::CdmaEvdo:
+    case NetworkManager::ModemDevice::Lte:
+        deviceText = i18nc("title of the interface widget in nm's popup", "Mobile Broadband");
+        break;
+    case NetworkManager::ModemDevice::NoCapability:
+        break;
+    }
+    return deviceText;
+}
+
+QString UiUtils::interfaceTypeLabel(const NetworkManager::Device::Type type, const NetworkManager::Device::Ptr iface)
+{
+    if (type == NetworkManager::Device::Modem) {
+        const NetworkManager::ModemDevice::Ptr nmModemIface = iface.objectCast<NetworkManager::ModemDevice>();
+        if (!nmModemIface) {
+            return QString();
+        }
+
+        const NetworkManager::ModemDevice::Capability modemType = modemSubType(nmModemIface->currentCapabilities());
+        if (modemType == NetworkManager::ModemDevice::NoCapability) {
+            qCWarning(PLASMA_NM) << "Unhandled modem sub type: NetworkManager::ModemDevice::NoCapability";
+            return QString();
+        }
+
+        return s_labelCache->label(ModemTypeLabel, modemType, [modemType] () { return modemTypeText(modemType); });
+    }
+
+    return s_labelCache->label(InterfaceTypeLabel, type, [type] () { return interfaceTypeText(type); });
+}
+
 QString UiUtils::iconAndTitleForConnectionSettingsType(NetworkManager::ConnectionSettings::ConnectionType type, QString &title)
 {
     QString text;
@@ -293,7 +374,7 @@ QString UiUtils::prettyInterfaceName(NetworkManager::Device::Type type, const QS
     return ret;
 }
 
-QString UiUtils::connectionStateToString(NetworkManager::Device::State state, const QString &connectionName)
+static QString deviceStateText(NetworkManager::Device::State state, const QString &connectionName)
 {
     QString stateString;
     switch (state) {
@@ -346,7 +427,17 @@ QString UiUtils::connectionStateToString(NetworkManager::Device::State state, co
     return stateString;
 }
 
-QString UiUtils::vpnConnectionStateToString(VpnConnection::State state)
+QString UiUtils::connectionStateToString(NetworkManager::Device::State state, const QString &connectionName)
+{
+    // Labels with the connection name are not worth keeping
+    if (state == NetworkManager::Device::Activated && !connectionName.isEmpty()) {
+        return deviceStateText(state, connectionName);
+    }
+
+    return s_labelCache->label(DeviceStateLabel, state, [state] () { return deviceStateText(state, QString()); });
+}
+
+static QString vpnStateText(VpnConnection::State state)
 {
     QString stateString;
     switch (state) {
@@ -379,7 +470,12 @@ QString UiUtils::vpnConnectionStateToString(VpnConnection::State state)
     return stateString;
 }
 
-QString UiUtils::operationModeToString(NetworkManager::WirelessDevice::OperationMode mode)
+QString UiUtils::vpnConnectionStateToString(VpnConnection::State state)
+{
+    return s_labelCache->label(VpnStateLabel, state, [state] () { return vpnStateText(state); });
+}
+
+static QString operationModeText(NetworkManager::WirelessDevice::OperationMode mode)
 {
     QString modeString;
     switch (mode) {
@@ -401,6 +497,11 @@ QString UiUtils::operationModeToString(NetworkManager::WirelessDevice::Operation
     return modeString;
 }
 
+QString UiUtils::operationModeToString(NetworkManager::WirelessDevice::OperationMode mode)
+{
+    return s_labelCache->label(OperationModeLabel, mode, [mode] () { return operationModeText(mode); });
+}
+
 QStringList UiUtils::wpaFlagsToStringList(NetworkManager::AccessPoint::WpaFlags flags)
 {
     /* for testing purposes
@@ -473,7 +574,7 @@ QString UiUtils::wirelessBandToString(NetworkManager::WirelessSetting::Frequency
 }
 
 #if WITH_MODEMMANAGER_SUPPORT
-QString UiUtils::convertAllowedModeToString(ModemManager::Modem::ModemModes modes)
+static QString allowedModeText(ModemManager::Modem::ModemModes modes)
 {
     if (modes.testFlag(MM_MODEM_MODE_4G)) {
         return i18nc("Gsm modes (2G/3G/any)","LTE");
@@ -490,7 +591,12 @@ QString UiUtils::convertAllowedModeToString(ModemManager::Modem::ModemModes mode
     return i18nc("Gsm modes (2G/3G/any)","Any");
 }
 
-QString UiUtils::convertAccessTechnologyToString(ModemManager::Modem::AccessTechnologies tech)
+QString UiUtils::convertAllowedModeToString(ModemManager::Modem::ModemModes modes)
+{
+    return s_labelCache->label(AllowedModeLabel, int(modes), [modes] () { return allowedModeText(modes); });
+}
+
+static QString accessTechnologyText(ModemManager::Modem::AccessTechnologies tech)
 {
     if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_LTE)) {
         return i18nc("Cellular access technology","LTE");
@@ -531,7 +637,12 @@ QString UiUtils::convertAccessTechnologyToString(ModemManager::Modem::AccessTech
     return i18nc("Unknown cellular access technology","Unknown");
 }
 
-QString UiUtils::convertLockReasonToString(MMModemLock reason)
+QString UiUtils::convertAccessTechnologyToString(ModemManager::Modem::AccessTechnologies tech)
+{
+    return s_labelCache->label(AccessTechnologyLabel, int(tech), [tech] () { return accessTechnologyText(tech); });
+}
+
+static QString lockReasonText(MMModemLock reason)
 {
     switch (reason) {
     case MM_MODEM_LOCK_NONE:
@@ -571,6 +682,11 @@ QString UiUtils::convertLockReasonToString(MMModemLock reason)
         return i18nc("possible SIM lock reason", "Lock reason unknown.");
     }
 }
+
+QString UiUtils::convertLockReasonToString(MMModemLock reason)
+{
+    return s_labelCache->label(LockReasonLabel, reason, [reason] () { return lockReasonText(reason); });
+}
 #endif
 
 NetworkManager::ModemDevice::Capability UiUtils::modemSubType(NetworkManager::ModemDevice::Capabilities modemCaps)
@@ -587,7 +703,7 @@ NetworkManager::ModemDevice::Capability UiUtils::modemSubType(NetworkManager::Mo
     return NetworkManager::ModemDevice::NoCapability;
 }
 
-QString UiUtils::labelFromWirelessSecurity(NetworkManager::WirelessSecurityType type)
+static QString wirelessSecurityText(NetworkManager::WirelessSecurityType type)
 {
     QString tip;
     switch (type) {
@@ -625,6 +741,11 @@ QString UiUtils::labelFromWirelessSecurity(NetworkManager::WirelessSecurityType
     return tip;
 }
 
+QString UiUtils::labelFromWirelessSecurity(NetworkManager::WirelessSecurityType type)
+{
+    return s_labelCache->label(WirelessSecurityLabel, type, [type] () { return wirelessSecurityText(type); });
+}
+
 QString UiUtils::formatDateRelative(const QDateTime & lastUsed)
 {
     QString lastUsedText;
@@ -18,6 +18,7 @@
  */
 
 #include "mobilebroadbandsettings.h"
+#include "mobileproviders.h"
 
 #include <KPluginFactory>
 #include <KLocalizedString>
@@ -31,6 +32,8 @@
 #include <ModemManagerQt/Manager>
 #include <ModemManagerQt/GenericTypes>
 #include <ModemManagerQt/ModemDevice>
+#include <ModemManagerQt/modem3gpp.h>
+#include <ModemManagerQt/sim.h>
 #endif
 
 K_PLUGIN_CLASS_WITH_JSON(MobileBroadbandSettings, "mobilebroadbandsettings.json")
@@ -48,6 +51,7 @@ MobileBroadbandSettings::MobileBroadbandSettings(QObject* parent, const QVariant
 
 MobileBroadbandSettings::~MobileBroadbandSettings()
 {
+    delete m_providers;
 }
 
 bool MobileBroadbandSettings::mobileDataActive()
@@ -103,7 +107,33 @@ void MobileBroadbandSettings::setupMobileNetwork()
 
 QString MobileBroadbandSettings::getAPN()
 {
-    return "some.ap.placeholder.com";
+#if WITH_MODEMMANAGER_SUPPORT
+    ModemManager::ModemDevice::Ptr modem = ModemManager::findModemDevice(getModemDevice());
+    if (!modem)
+        return QString();
+
+    // The SIM knows the home network, which is what the APN belongs to even when roaming
+    QString networkId;
+    QString spn;
+    ModemManager::Sim::Ptr sim = modem->sim();
+    if (sim) {
+        networkId = sim->operatorIdentifier();
+        spn = sim->operatorName();
+    }
+    if (networkId.isEmpty()) {
+        ModemManager::Modem3gpp::Ptr modem3gpp = modem->interface(ModemManager::ModemDevice::GsmInterface).objectCast<ModemManager::Modem3gpp>();
+        if (modem3gpp)
+            networkId = modem3gpp->operatorCode();
+    }
+    if (networkId.isEmpty())
+        return QString();
+
+    if (!m_providers)
+        m_providers = new MobileProviders();
+    return m_providers->getApnInfoByNetworkId(networkId, spn).value(QStringLiteral("apn")).toString();
+#else
+    return QString();
+#endif
 }
 
 #include "mobilebroadbandsettings.moc"
@@ -22,6 +22,8 @@
 
 #include <KQuickAddons/ConfigModule>
 
+class MobileProviders;
+
 class MobileBroadbandSettings : public KQuickAddons::ConfigModule
 {
     Q_OBJECT
@@ -40,6 +42,7 @@ public:
 
 private:
     bool m_mobileDataActive;
+    MobileProviders *m_providers = nullptr;
 };
 
 #endif // MOBILEBROADBANDSETTINGS_H
@@ -47,7 +47,8 @@ Item {
     }
 
     function initParams() {
-        currentType = kcm.getConnectionType()
+        var details = kcm.details
+        currentType = details.type
         if (currentType == "L2TP") {
             initL2tp()
         } else if (currentType == "PPTP") {
@@ -56,16 +57,16 @@ Item {
             initOpenVPN()
         }
 
-        tf_des.text = kcm.getDescription()
-        tf_gateWay.text = kcm.getServerName()
-        tf_domain.text = kcm.getDomainName()
-        tf_userName.text = kcm.getUserName()
-        tf_passWord.text = kcm.getPassword()
-        tf_prekey.text = kcm.getPreSharedKey()
-        tf_ca.text = kcm.getCACertificate()
-        tf_cert.text = kcm.getUserCertificate()
-        tf_key.text = kcm.getPrivateKeyCertificate()
-        tf_auth.text = kcm.getStaticKeyCertificate()
+        tf_des.text = details.description
+        tf_gateWay.text = details.serverName
+        tf_domain.text = details.domainName
+        tf_userName.text = details.userName
+        tf_passWord.text = details.password
+        tf_prekey.text = details.preSharedKey
+        tf_ca.text = details.caCertificate
+        tf_cert.text = details.userCertificate
+        tf_key.text = details.privateKeyCertificate
+        tf_auth.text = details.staticKeyCertificate
     }
 
     Rectangle {
@@ -199,7 +199,7 @@ Item {
 
                         font.pixelSize: 14
                         color: "#99000000"
-                        text: kcm.getConnectionType()
+                        text: kcm.details.type
                     }
                 }
 
@@ -252,7 +252,7 @@ Item {
 
                         font.pixelSize: 14
                         color: "#99000000"
-                        text: kcm.getServerName()
+                        text: kcm.details.serverName
                     }
                 }
 
@@ -307,7 +307,7 @@ Item {
 
                         font.pixelSize: 14
                         color: "#99000000"
-                        text: kcm.getUserName()
+                        text: kcm.details.userName
                     }
                 }
             }
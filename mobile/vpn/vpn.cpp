@@ -239,61 +239,162 @@ void VPN::deactivateVPNConnection(const QString &connection, const QString &devi
 void VPN::onDetailClicked(const QString connectionPath,const QString devicePath)
 {
     m_connectionPath = connectionPath;
-    NetworkManager::Connection::Ptr m_connection = NetworkManager::findConnection(connectionPath);
-    if (m_connection) {
-        m_connectionSettings = m_connection->settings();
-        m_vpnSetting =
-            m_connectionSettings->setting(NetworkManager::Setting::Vpn).staticCast<NetworkManager::VpnSetting>();
-    }
     NetworkManager::Device::Ptr device = NetworkManager::findNetworkInterface(devicePath);
     if(device){
         m_device = device;
     }
+    loadSecrets(m_connectionPath);
+    Q_EMIT detailsChanged();
+}
+
+VpnDetails VPN::details()
+{
+    // Only the selected profile needs its secrets, the list shows the data part only
+    loadSecrets(m_connectionPath);
+    return connectionDetails(m_connectionPath);
+}
+
+VpnDetails VPN::connectionDetails(const QString &connectionPath)
+{
+    auto it = m_details.constFind(connectionPath);
+    if (it != m_details.constEnd()) {
+        return it.value();
+    }
+
+    VpnDetails details;
+    details.connectionPath = connectionPath;
+    NetworkManager::Connection::Ptr connection = NetworkManager::findConnection(connectionPath);
+    if (!connection) {
+        return details;
+    }
+
+    NetworkManager::ConnectionSettings::Ptr settings = connection->settings();
+    details.description = settings->id();
+    NetworkManager::VpnSetting::Ptr vpnSetting = settings->setting(NetworkManager::Setting::Vpn).staticCast<NetworkManager::VpnSetting>();
+    if (vpnSetting) {
+        const NMStringMap dataMap = vpnSetting->data();
+        const QString type = vpnSetting->serviceType();
+        if(type == QLatin1String(NM_DBUS_SERVICE_L2TP)){
+            details.type = "L2TP";
+            details.serverName = dataMap[NM_L2TP_KEY_GATEWAY];
+            details.domainName = dataMap[NM_L2TP_KEY_DOMAIN];
+            details.userName = dataMap[NM_L2TP_KEY_USER];
+            details.preSharedKey = dataMap[NM_L2TP_KEY_IPSEC_PSK];
+        }else if(type == QLatin1String(NM_DBUS_SERVICE_PPTP)){
+            details.type = "PPTP";
+            details.serverName = dataMap[NM_PPTP_KEY_GATEWAY];
+            details.domainName = dataMap[NM_PPTP_KEY_DOMAIN];
+            details.userName = dataMap[NM_PPTP_KEY_USER];
+        }else if(type == QLatin1String(NM_DBUS_SERVICE_OPENVPN)){
+            details.type = "OpenVPN";
+            details.serverName = dataMap[NM_OPENVPN_KEY_REMOTE];
+            details.userName = dataMap[NM_OPENVPN_KEY_USERNAME];
+            details.caCertificate = dataMap[NM_OPENVPN_KEY_CA];
+            details.userCertificate = dataMap[NM_OPENVPN_KEY_CERT];
+            details.privateKeyCertificate = dataMap[NM_OPENVPN_KEY_KEY];
+            details.staticKeyCertificate = dataMap[NM_OPENVPN_KEY_TA];
+        }else{
+            details.type = "Unkown";
+            details.serverName = dataMap[NM_L2TP_KEY_GATEWAY];
+        }
+    }
+
+    // Drop the snapshot whenever the profile changes, it gets rebuilt on next access
+    if (!m_watchedConnections.contains(connectionPath)) {
+        m_watchedConnections.insert(connectionPath);
+        connect(connection.data(), &NetworkManager::Connection::updated, this, [this, connectionPath] () {
+            invalidateDetails(connectionPath);
+        });
+        connect(connection.data(), &NetworkManager::Connection::removed, this, [this, connectionPath] () {
+            m_watchedConnections.remove(connectionPath);
+            invalidateDetails(connectionPath);
+        });
+    }
+
+    m_details.insert(connectionPath, details);
+    return details;
+}
+
+void VPN::loadSecrets(const QString &connectionPath)
+{
+    if (connectionPath.isEmpty() || m_secretsRequests.contains(connectionPath)) {
+        return;
+    }
+
+    if (connectionDetails(connectionPath).secretsLoaded) {
+        return;
+    }
+
+    NetworkManager::Connection::Ptr connection = NetworkManager::findConnection(connectionPath);
+    if (connection) {
+        requestSecrets(connection);
+    }
 }
 
+void VPN::invalidateDetails(const QString &connectionPath)
+{
+    // Secrets requested for the old settings must not end up in the new snapshot
+    m_secretsRequests.remove(connectionPath);
+    if (m_details.remove(connectionPath)) {
+        Q_EMIT connectionDetailsChanged(connectionPath);
+        if (connectionPath == m_connectionPath) {
+            Q_EMIT detailsChanged();
+        }
+    }
+}
+
+void VPN::requestSecrets(const NetworkManager::Connection::Ptr &connection)
+{
+    QDBusPendingReply<NMVariantMapMap> reply = connection->secrets(QLatin1String("vpn"));
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
+    watcher->setProperty("connectionPath", connection->path());
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &VPN::replyFinished);
+    m_secretsRequests.insert(connection->path(), watcher);
+}
 
 void VPN::replyFinished(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<NMVariantMapMap> reply = *watcher;
-    const QString settingName = watcher->property("settingName").toString();
+    const QString connectionPath = watcher->property("connectionPath").toString();
+    watcher->deleteLater();
+
+    // The snapshot could have been invalidated meanwhile, secrets are requested again
+    // when the profile is selected
+    if (m_secretsRequests.value(connectionPath) != watcher) {
+        return;
+    }
+    m_secretsRequests.remove(connectionPath);
+
+    auto it = m_details.find(connectionPath);
+    if (it == m_details.end()) {
+        return;
+    }
+
     if (reply.isValid()) {
-        NMVariantMapMap secrets = reply.argumentAt<0>();
-        for (const QString &key : secrets.keys()) {
-            if (key == settingName) {
-                NetworkManager::Setting::Ptr setting = m_connectionSettings->setting(NetworkManager::Setting::typeFromString(key));
-                if (setting) {
-                    setting->secretsFromMap(secrets.value(key));
-                    NetworkManager::VpnSetting::Ptr vpnSetting = setting.staticCast<NetworkManager::VpnSetting>();
-                    const NMStringMap dataMap = vpnSetting->data();
-                    const NMStringMap secrets = vpnSetting->secrets();
-                    QString type = m_vpnSetting->serviceType();
-                    if(type == QLatin1String(NM_DBUS_SERVICE_L2TP)){
-                        m_pwd =  secrets.value(NM_L2TP_KEY_PASSWORD);
-                    }else if(type == QLatin1String(NM_DBUS_SERVICE_PPTP)){
-                        m_pwd =  secrets.value(NM_PPTP_KEY_PASSWORD);
-                    }else if(type == QLatin1String(NM_DBUS_SERVICE_OPENVPN)){
-                        m_pwd =  secrets.value(NM_OPENVPN_KEY_CERTPASS);
-                    }
-                    Q_EMIT passwordReplyFinished(m_pwd);
-                }
-            }
+        NetworkManager::VpnSetting vpnSetting;
+        vpnSetting.secretsFromMap(reply.argumentAt<0>().value(QLatin1String("vpn")));
+        const NMStringMap secrets = vpnSetting.secrets();
+        if(it->type == QLatin1String("L2TP")){
+            it->password = secrets.value(NM_L2TP_KEY_PASSWORD);
+        }else if(it->type == QLatin1String("PPTP")){
+            it->password = secrets.value(NM_PPTP_KEY_PASSWORD);
+        }else if(it->type == QLatin1String("OpenVPN")){
+            it->password = secrets.value(NM_OPENVPN_KEY_CERTPASS);
         }
     }
-    watcher->deleteLater();
+    it->secretsLoaded = true;
+
+    Q_EMIT connectionDetailsChanged(connectionPath);
+    if (connectionPath == m_connectionPath) {
+        Q_EMIT detailsChanged();
+        Q_EMIT passwordReplyFinished(it->password);
+    }
 }
 
 QString VPN::getConnectionType()
 {
-    const NMStringMap dataMap = m_vpnSetting->data();
-    QString type = m_vpnSetting->serviceType();
-    if(type == QLatin1String(NM_DBUS_SERVICE_L2TP)){
-        return "L2TP";
-    }else if(type == QLatin1String(NM_DBUS_SERVICE_PPTP)){
-        return "PPTP";
-    }else if(type == QLatin1String(NM_DBUS_SERVICE_OPENVPN)){
-        return "OpenVPN";
-    }
-    return "Unkown";
+    const QString type = details().type;
+    return type.isEmpty() ? QStringLiteral("Unkown") : type;
 }
 QString VPN::getIpAdress()
 {
@@ -310,152 +411,68 @@ QString VPN::getIpAdress()
 
 QString VPN::getUserName()
 {
-    const NMStringMap dataMap = m_vpnSetting->data(); 
-    QString type = m_vpnSetting->serviceType();
-    if(type == QLatin1String(NM_DBUS_SERVICE_L2TP)){
-        return dataMap[NM_L2TP_KEY_USER];
-    }else if(type == QLatin1String(NM_DBUS_SERVICE_PPTP)){
-        return dataMap[NM_PPTP_KEY_USER];
-    }else if(type == QLatin1String(NM_DBUS_SERVICE_OPENVPN)){
-        return dataMap[NM_OPENVPN_KEY_USERNAME];
-    }
-    return "";
+    return details().userName;
 }
 
 QString VPN::getCACertificate()
 {
-    const NMStringMap dataMap = m_vpnSetting->data(); 
-    QString type = m_vpnSetting->serviceType();
-    if(type == QLatin1String(NM_DBUS_SERVICE_OPENVPN)){
-        return dataMap[NM_OPENVPN_KEY_CA];
-    }
-    return "";
+    return details().caCertificate;
 }
 
 QString VPN::getUserCertificate()
 {
-    const NMStringMap dataMap = m_vpnSetting->data(); 
-    QString type = m_vpnSetting->serviceType();
-    if(type == QLatin1String(NM_DBUS_SERVICE_OPENVPN)){
-        return dataMap[NM_OPENVPN_KEY_CERT];
-    }
-    return "";
+    return details().userCertificate;
 }
 
 QString VPN::getPrivateKeyCertificate()
 {
-    const NMStringMap dataMap = m_vpnSetting->data(); 
-    QString type = m_vpnSetting->serviceType();
-    if(type == QLatin1String(NM_DBUS_SERVICE_OPENVPN)){
-        return dataMap[NM_OPENVPN_KEY_KEY];
-    }
-    return "";
+    return details().privateKeyCertificate;
 }
 
 QString VPN::getStaticKeyCertificate()
 {
-    const NMStringMap dataMap = m_vpnSetting->data(); 
-    QString type = m_vpnSetting->serviceType();
-    if(type == QLatin1String(NM_DBUS_SERVICE_OPENVPN)){
-        return dataMap[NM_OPENVPN_KEY_TA];
-    }
-    return "";
+    return details().staticKeyCertificate;
 }
 
 QString VPN::getUserName(const QString connectionPath)
 {
-    NetworkManager::Connection::Ptr m_connection = NetworkManager::findConnection(connectionPath);
-    if (m_connection) {
-        m_vpnSetting =
-            m_connection->settings()->setting(NetworkManager::Setting::Vpn).staticCast<NetworkManager::VpnSetting>();
-            const NMStringMap dataMap = m_vpnSetting->data(); 
-            QString type = m_vpnSetting->serviceType();
-            if(type == QLatin1String(NM_DBUS_SERVICE_L2TP)){
-                return dataMap[NM_L2TP_KEY_USER];
-            }else if(type == QLatin1String(NM_DBUS_SERVICE_PPTP)){
-                return dataMap[NM_PPTP_KEY_USER];
-            }else if(type == QLatin1String(NM_DBUS_SERVICE_OPENVPN)){
-                return "openvpn";
-        }
+    const VpnDetails details = connectionDetails(connectionPath);
+    // OpenVPN profiles are listed by their type instead of the user
+    if (details.type == QLatin1String("OpenVPN")) {
+        return "openvpn";
     }
-    
-    return "";
+    return details.userName;
 }
 
 QString VPN::getServerName(const QString connectionPath)
 {
-    NetworkManager::Connection::Ptr m_connection = NetworkManager::findConnection(connectionPath);
-    if (m_connection) {
-        m_vpnSetting =
-            m_connection->settings()->setting(NetworkManager::Setting::Vpn).staticCast<NetworkManager::VpnSetting>();
-            const NMStringMap dataMap = m_vpnSetting->data();
-            QString type = m_vpnSetting->serviceType();
-            if(type == QLatin1String(NM_DBUS_SERVICE_L2TP)){
-                return dataMap[NM_L2TP_KEY_GATEWAY];
-            }else if(type == QLatin1String(NM_DBUS_SERVICE_PPTP)){
-                return dataMap[NM_PPTP_KEY_GATEWAY];
-            }else if(type == QLatin1String(NM_DBUS_SERVICE_OPENVPN)){
-                return dataMap[NM_OPENVPN_KEY_REMOTE];
-            }
-    }
-    
-    return "";
+    return connectionDetails(connectionPath).serverName;
 }
 
 QString VPN::getServerName()
 {
-    const NMStringMap dataMap = m_vpnSetting->data();
-    QString type = m_vpnSetting->serviceType();
-    if(type == QLatin1String(NM_DBUS_SERVICE_L2TP)){
-        return dataMap[NM_L2TP_KEY_GATEWAY];
-    }else if(type == QLatin1String(NM_DBUS_SERVICE_PPTP)){
-        return dataMap[NM_PPTP_KEY_GATEWAY];
-    }else if(type == QLatin1String(NM_DBUS_SERVICE_OPENVPN)){
-        return dataMap[NM_OPENVPN_KEY_REMOTE];
-    }
-    
-    return dataMap[NM_L2TP_KEY_GATEWAY];
+    return details().serverName;
 }
 
 QString VPN::getDomainName()
 {
-    const NMStringMap dataMap = m_vpnSetting->data();
-    QString type = m_vpnSetting->serviceType();
-    if(type == QLatin1String(NM_DBUS_SERVICE_L2TP)){
-        return dataMap[NM_L2TP_KEY_DOMAIN];
-    }else if(type == QLatin1String(NM_DBUS_SERVICE_PPTP)){
-        return dataMap[NM_PPTP_KEY_DOMAIN];
-    }
-    return "";
+    return details().domainName;
 }
 
 QString VPN::getPassword()
 {
-    NetworkManager::Connection::Ptr m_connection = NetworkManager::findConnection(m_connectionPath);
-    if (m_connection) {
-        QDBusPendingReply<NMVariantMapMap> reply = m_connection->secrets( QLatin1String("vpn"));
-        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
-        watcher->setProperty("connection", m_connection->name());
-        watcher->setProperty("settingName", QLatin1String("vpn"));
-        connect(watcher, &QDBusPendingCallWatcher::finished, this, &VPN::replyFinished);
-    }
-    
-    return m_pwd;
+    // Filled in asynchronously, passwordReplyFinished tells when
+    return details().password;
 }
 
 QString VPN::getDescription()
 {
-    return m_connectionSettings->id();
+    return details().description;
 }
 
 QString VPN::getPreSharedKey()
 {
-    const NMStringMap dataMap = m_vpnSetting->data();
-    QString type = m_vpnSetting->serviceType();
-    if(type == QLatin1String(NM_DBUS_SERVICE_L2TP)){
-        return dataMap[NM_L2TP_KEY_IPSEC_PSK];
-    }
-    return "";
+    return details().preSharedKey;
 }
 
 void VPN::addActiveConnection(const QString &path)
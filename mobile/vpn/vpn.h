@@ -24,17 +24,59 @@
 
 
 #include <KQuickAddons/ConfigModule>
+#include <QHash>
 #include <QObject>
+#include <QSet>
 #include "handler.h"
+#include <NetworkManagerQt/Connection>
 #include <NetworkManagerQt/VpnSetting>
 #include <NetworkManagerQt/VpnConnection>
 #include <NetworkManagerQt/Device>
 #include <NetworkManagerQt/Manager>
 
 
+/**
+ * Everything the detail pages show about a VPN profile, secrets are filled in
+ * asynchronously once VPN::loadSecrets() is called (see secretsLoaded)
+ */
+class VpnDetails
+{
+    Q_GADGET
+    Q_PROPERTY(QString connectionPath MEMBER connectionPath)
+    Q_PROPERTY(QString type MEMBER type)
+    Q_PROPERTY(QString description MEMBER description)
+    Q_PROPERTY(QString serverName MEMBER serverName)
+    Q_PROPERTY(QString domainName MEMBER domainName)
+    Q_PROPERTY(QString userName MEMBER userName)
+    Q_PROPERTY(QString password MEMBER password)
+    Q_PROPERTY(QString preSharedKey MEMBER preSharedKey)
+    Q_PROPERTY(QString caCertificate MEMBER caCertificate)
+    Q_PROPERTY(QString userCertificate MEMBER userCertificate)
+    Q_PROPERTY(QString privateKeyCertificate MEMBER privateKeyCertificate)
+    Q_PROPERTY(QString staticKeyCertificate MEMBER staticKeyCertificate)
+    Q_PROPERTY(bool secretsLoaded MEMBER secretsLoaded)
+public:
+    QString connectionPath;
+    QString type;
+    QString description;
+    QString serverName;
+    QString domainName;
+    QString userName;
+    QString password;
+    QString preSharedKey;
+    QString caCertificate;
+    QString userCertificate;
+    QString privateKeyCertificate;
+    QString staticKeyCertificate;
+    bool secretsLoaded = false;
+};
+Q_DECLARE_METATYPE(VpnDetails)
+
 class VPN : public KQuickAddons::ConfigModule
 {
     Q_OBJECT
+    // Profile selected with onDetailClicked()
+    Q_PROPERTY(VpnDetails details READ details NOTIFY detailsChanged)
 public:
     VPN(QObject *parent, const QVariantList &args);
     Q_INVOKABLE void addVPNConnection(const QString type, const QString dec, const QString userName, const QString passWord, const QString gateWay, const QString domain, const QString key, const QString caPath, const QString certPath, const QString keyPath, const QString authPath);
@@ -43,6 +85,17 @@ public:
     Q_INVOKABLE void removeVPNConnection(const QString & connection);
     Q_INVOKABLE void deactivateVPNConnection(const QString &connection, const QString &device);
     Q_INVOKABLE void onDetailClicked(const QString connectionPath, const QString devicePath);
+    /**
+     * Returns the snapshot of given profile, it is cached until the profile changes.
+     * Secrets are not part of it until loadSecrets() is called for the profile.
+     */
+    Q_INVOKABLE VpnDetails connectionDetails(const QString &connectionPath);
+    /**
+     * Asks for the secrets of given profile, connectionDetailsChanged() is emitted once they arrive.
+     * Done automatically for the profile selected with onDetailClicked().
+     */
+    Q_INVOKABLE void loadSecrets(const QString &connectionPath);
+    VpnDetails details();
     Q_INVOKABLE QString getConnectionType();
     Q_INVOKABLE QString getServerName();
     Q_INVOKABLE QString getDomainName();
@@ -66,6 +119,8 @@ Q_SIGNALS:
     void vpnConnectedFaild(NetworkManager::VpnConnection::State state);
     void vpnConnectedSuccess(NetworkManager::VpnConnection::State state);
     void passwordReplyFinished(const QString pwd);
+    void detailsChanged();
+    void connectionDetailsChanged(const QString &connectionPath);
     
 private Q_SLOTS:
     void replyFinished(QDBusPendingCallWatcher *watcher);
@@ -74,13 +129,17 @@ private Q_SLOTS:
     void onVpnConnectionStateChanged(NetworkManager::VpnConnection::State state, NetworkManager::VpnConnection::StateChangeReason reason); 
 
 private:
+    void invalidateDetails(const QString &connectionPath);
+    void requestSecrets(const NetworkManager::Connection::Ptr &connection);
+
     Handler *m_handler;
     QString m_connectionPath;
-    QString m_pwd;
-    NetworkManager::VpnSetting::Ptr m_vpnSetting;
     NetworkManager::Device::Ptr m_device;
-    NetworkManager::ConnectionSettings::Ptr m_connectionSettings;
     QSettings m_settings;
+    QHash<QString, VpnDetails> m_details;
+    // Pending secrets request of every profile
+    QHash<QString, QDBusPendingCallWatcher *> m_secretsRequests;
+    QSet<QString> m_watchedConnections;
 };
 
 #endif
@@ -41,6 +41,10 @@
 #include <KUser>
 #include <KNotification>
 
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QQmlEngine>
+
 
 K_PLUGIN_CLASS_WITH_JSON(WifiSettings, "wifisettings.json")
 
@@ -92,6 +96,63 @@ QVariantMap WifiSettings::getConnectionSettings(const QString &connection, const
     return map;
 }
 
+void WifiSettings::requestSecrets(const QString &connection, const QJSValue &callback)
+{
+    auto it = m_pendingSecrets.find(connection);
+    if (it != m_pendingSecrets.end()) {
+        if (callback.isCallable())
+            it->append(callback);
+        return;
+    }
+
+    NetworkManager::Connection::Ptr con = NetworkManager::findConnection(connection);
+    if (!con) {
+        m_pendingSecrets.insert(connection, {callback});
+        finishSecretsRequest(connection, QVariantMap(), i18n("Connection %1 not found", connection));
+        return;
+    }
+
+    QList<QJSValue> callbacks;
+    if (callback.isCallable())
+        callbacks << callback;
+    m_pendingSecrets.insert(connection, callbacks);
+
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(con->secrets(QLatin1String("802-11-wireless-security")), this);
+    watcher->setProperty("connection", connection);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &WifiSettings::secretsReplyFinished);
+}
+
+void WifiSettings::secretsReplyFinished(QDBusPendingCallWatcher *watcher)
+{
+    const QDBusPendingReply<NMVariantMapMap> reply = *watcher;
+    const QString connection = watcher->property("connection").toString();
+    watcher->deleteLater();
+
+    if (reply.isValid()) {
+        finishSecretsRequest(connection, reply.value().value(QLatin1String("802-11-wireless-security")), QString());
+    } else {
+        qWarning() << "Failed to get secrets for" << connection << reply.error().message();
+        finishSecretsRequest(connection, QVariantMap(), reply.error().message());
+    }
+}
+
+void WifiSettings::finishSecretsRequest(const QString &connection, const QVariantMap &secrets, const QString &message)
+{
+    const QList<QJSValue> callbacks = m_pendingSecrets.take(connection);
+
+    for (QJSValue callback : callbacks) {
+        if (!callback.isCallable())
+            continue;
+        const QJSValue secretsValue = engine() ? engine()->toScriptValue(secrets) : QJSValue();
+        callback.call({secretsValue, QJSValue(message)});
+    }
+
+    if (message.isEmpty())
+        emit secretsReceived(connection, secrets);
+    else
+        emit secretsFailed(connection, message);
+}
+
 QVariantMap WifiSettings::getActiveConnectionInfo(const QString &connection)
 {
     if (connection.isEmpty())
@@ -24,6 +24,11 @@
 #include <KQuickAddons/ConfigModule>
 #include "handler.h"
 
+#include <QHash>
+#include <QJSValue>
+
+class QDBusPendingCallWatcher;
+
 
 class WifiSettings : public KQuickAddons::ConfigModule
 {
@@ -31,7 +36,14 @@ class WifiSettings : public KQuickAddons::ConfigModule
     
 public:
     WifiSettings(QObject *parent, const QVariantList &args);
+    // Type "secrets" blocks until the secret agent answers, use requestSecrets() instead
     Q_INVOKABLE QVariantMap getConnectionSettings(const QString &connection, const QString &type);
+    /**
+     * Asynchronously fetches Wi-Fi secrets of given connection. The result is passed to
+     * @callback as (secrets, errorMessage) and announced by secretsReceived/secretsFailed.
+     * Requests for a connection which is already being asked for share the pending reply.
+     */
+    Q_INVOKABLE void requestSecrets(const QString &connection, const QJSValue &callback = QJSValue());
     Q_INVOKABLE QVariantMap getActiveConnectionInfo(const QString &connection);
     Q_INVOKABLE void addConnectionFromQML(const QVariantMap &QMLmap);
     Q_INVOKABLE void updateConnectionFromQML(const QString &path, const QVariantMap &map);
@@ -47,9 +59,20 @@ public:
     Q_INVOKABLE void addNoSecurityConnection(QString connectionPath,QString devicePath,QString specificPath);
     Q_INVOKABLE void setHandler(Handler *handler);
 
+Q_SIGNALS:
+    void secretsReceived(const QString &connection, const QVariantMap &secrets);
+    void secretsFailed(const QString &connection, const QString &message);
+
+private Q_SLOTS:
+    void secretsReplyFinished(QDBusPendingCallWatcher *watcher);
+
 private:
+    void finishSecretsRequest(const QString &connection, const QVariantMap &secrets, const QString &message);
+
     Handler *m_handler;
     bool isActiveEnable;
+    // Callbacks waiting for secrets, by connection path
+    QHash<QString, QList<QJSValue>> m_pendingSecrets;
 };
 
 #endif // WIFISETTINGS_H
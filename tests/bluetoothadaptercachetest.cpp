@@ -0,0 +1,205 @@
+/*
+Copyright 2021  Wang Rui <wangrui@jingos.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bluetoothadaptercache.h"
+
+#include <NetworkManagerQt/GenericTypes>
+
+#include <QDBusAbstractAdaptor>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusMetaType>
+#include <QDBusObjectPath>
+#include <QTest>
+
+#define FAKE_BLUEZ_SERVICE "org.kde.plasmanm.FakeBluez"
+
+typedef QMap<QDBusObjectPath, NMVariantMapMap> ManagedObjects;
+
+// Fake org.bluez.Adapter1, Set on Powered is handled by QtDBus through the property
+class FakeAdapter : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.bluez.Adapter1")
+    Q_PROPERTY(bool Powered READ powered WRITE setPowered)
+public:
+    FakeAdapter(QObject *parent, const QDBusConnection &bus, const QString &path, bool powered)
+        : QDBusAbstractAdaptor(parent)
+        , m_bus(bus)
+        , m_path(path)
+        , m_powered(powered)
+    {
+    }
+
+    bool powered() const
+    {
+        return m_powered;
+    }
+
+    void setPowered(bool powered)
+    {
+        m_powered = powered;
+
+        QDBusMessage signal = QDBusMessage::createSignal(m_path, QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("PropertiesChanged"));
+        signal << QStringLiteral("org.bluez.Adapter1") << QVariantMap{ {QStringLiteral("Powered"), powered} } << QStringList();
+        m_bus.send(signal);
+    }
+
+    QVariantMap properties() const
+    {
+        return { {QStringLiteral("Powered"), m_powered} };
+    }
+
+private:
+    QDBusConnection m_bus;
+    QString m_path;
+    bool m_powered;
+};
+
+class FakeObjectManager : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.DBus.ObjectManager")
+public:
+    FakeObjectManager(QObject *parent, const QDBusConnection &bus)
+        : QDBusAbstractAdaptor(parent)
+        , m_bus(bus)
+    {
+    }
+
+    FakeAdapter *addAdapter(const QString &path, bool powered)
+    {
+        QObject *object = new QObject(this);
+        FakeAdapter *adapter = new FakeAdapter(object, m_bus, path, powered);
+        m_bus.registerObject(path, object, QDBusConnection::ExportAdaptors);
+        m_adapters.insert(path, adapter);
+
+        QDBusMessage signal = QDBusMessage::createSignal(QStringLiteral("/"), QStringLiteral("org.freedesktop.DBus.ObjectManager"), QStringLiteral("InterfacesAdded"));
+        const NMVariantMapMap interfaces { {QStringLiteral("org.bluez.Adapter1"), adapter->properties()} };
+        signal << QVariant::fromValue(QDBusObjectPath(path)) << QVariant::fromValue(interfaces);
+        m_bus.send(signal);
+
+        return adapter;
+    }
+
+    void removeAdapter(const QString &path)
+    {
+        m_bus.unregisterObject(path);
+        delete m_adapters.take(path)->parent();
+
+        QDBusMessage signal = QDBusMessage::createSignal(QStringLiteral("/"), QStringLiteral("org.freedesktop.DBus.ObjectManager"), QStringLiteral("InterfacesRemoved"));
+        signal << QVariant::fromValue(QDBusObjectPath(path)) << QStringList{ QStringLiteral("org.bluez.Adapter1") };
+        m_bus.send(signal);
+    }
+
+    FakeAdapter *adapter(const QString &path) const
+    {
+        return m_adapters.value(path);
+    }
+
+public Q_SLOTS:
+    ManagedObjects GetManagedObjects()
+    {
+        ManagedObjects objects;
+        for (auto it = m_adapters.constBegin(); it != m_adapters.constEnd(); ++it) {
+            objects.insert(QDBusObjectPath(it.key()), { {QStringLiteral("org.bluez.Adapter1"), it.value()->properties()} });
+        }
+        return objects;
+    }
+
+private:
+    QDBusConnection m_bus;
+    QMap<QString, FakeAdapter*> m_adapters;
+};
+
+class BluetoothAdapterCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void initialStateTest();
+    void poweredTest();
+    void hotplugTest();
+
+private:
+    QObject *m_root = nullptr;
+    FakeObjectManager *m_manager = nullptr;
+    BluetoothAdapterCache *m_cache = nullptr;
+};
+
+void BluetoothAdapterCacheTest::initTestCase()
+{
+    qDBusRegisterMetaType<NMVariantMapMap>();
+    qDBusRegisterMetaType<ManagedObjects>();
+
+    // The fake BlueZ lives on its own connection so that all traffic really goes through the bus
+    QDBusConnection bus = QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral("fakebluez"));
+    QVERIFY(bus.isConnected());
+
+    m_root = new QObject(this);
+    m_manager = new FakeObjectManager(m_root, bus);
+    m_manager->addAdapter(QStringLiteral("/org/bluez/hci0"), true);
+    m_manager->addAdapter(QStringLiteral("/org/bluez/hci1"), false);
+    QVERIFY(bus.registerObject(QStringLiteral("/"), m_root, QDBusConnection::ExportAdaptors));
+    QVERIFY(bus.registerService(QStringLiteral(FAKE_BLUEZ_SERVICE)));
+
+    m_cache = new BluetoothAdapterCache(QDBusConnection::sessionBus(), QStringLiteral(FAKE_BLUEZ_SERVICE), this);
+}
+
+void BluetoothAdapterCacheTest::cleanupTestCase()
+{
+    QDBusConnection::disconnectFromBus(QStringLiteral("fakebluez"));
+}
+
+void BluetoothAdapterCacheTest::initialStateTest()
+{
+    QTRY_VERIFY(m_cache->isReady());
+
+    const QMap<QString, bool> expected { {QStringLiteral("/org/bluez/hci0"), true}, {QStringLiteral("/org/bluez/hci1"), false} };
+    QCOMPARE(m_cache->adapters(), expected);
+}
+
+void BluetoothAdapterCacheTest::poweredTest()
+{
+    m_cache->setPowered(QStringLiteral("/org/bluez/hci0"), false);
+    QTRY_COMPARE(m_cache->adapters().value(QStringLiteral("/org/bluez/hci0"), true), false);
+    QCOMPARE(m_manager->adapter(QStringLiteral("/org/bluez/hci0"))->powered(), false);
+
+    // Changes done behind our back are picked up as well
+    m_manager->adapter(QStringLiteral("/org/bluez/hci1"))->setPowered(true);
+    QTRY_COMPARE(m_cache->adapters().value(QStringLiteral("/org/bluez/hci1")), true);
+}
+
+void BluetoothAdapterCacheTest::hotplugTest()
+{
+    m_manager->addAdapter(QStringLiteral("/org/bluez/hci2"), true);
+    QTRY_VERIFY(m_cache->adapters().contains(QStringLiteral("/org/bluez/hci2")));
+    QCOMPARE(m_cache->adapters().value(QStringLiteral("/org/bluez/hci2")), true);
+
+    m_manager->removeAdapter(QStringLiteral("/org/bluez/hci2"));
+    QTRY_VERIFY(!m_cache->adapters().contains(QStringLiteral("/org/bluez/hci2")));
+    QCOMPARE(m_cache->adapters().size(), 2);
+}
+
+QTEST_GUILESS_MAIN(BluetoothAdapterCacheTest)
+
+#include "bluetoothadaptercachetest.moc"
@@ -0,0 +1,95 @@
+/*
+Copyright 2021  Wang Rui <wangrui@jingos.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ciscopassword.h"
+
+#include <QTest>
+
+class CiscoPasswordTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decryptTest_data();
+    void decryptTest();
+    void invalidTest_data();
+    void invalidTest();
+    void decryptBenchmark();
+};
+
+void CiscoPasswordTest::decryptTest_data()
+{
+    QTest::addColumn<QString>("encrypted");
+    QTest::addColumn<QString>("password");
+
+    // From the cisco-decrypt manual page
+    QTest::newRow("letmein") << "9196FE0075E359E6A2486905A1EFAE9A11D652B2C588EF3FBA15574237302B74C194EC7D0DD16645CB534D94CE85FEC4"
+                             << "letmein";
+    QTest::newRow("secret") << "000102030405060708090A0B0C0D0E0F1011121341EA0057AA543208F6808EAD84C5EE0824623B360B4995183D249B87"
+                            << "secret";
+    QTest::newRow("lowercase") << "000102030405060708090a0b0c0d0e0f1011121341ea0057aa543208f6808ead84c5ee0824623b360b4995183d249b87"
+                               << "secret";
+    // Last byte of the salt overflows when deriving the key
+    QTest::newRow("full block padding") << "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF00A381A2CF4B43F7486D60AAD30D303B6260D0CBAD7426644E2FC3F4CF97167893ED5E3C"
+                                        << "12345678";
+    QTest::newRow("utf-8") << "6465666768696A6B6C6D6E6F7071727374757677B1F73348025370F909D1B222369817A1D06B145C3A79563AE458B073247230391BD57AB21336DF8376C7747D"
+                           << QString::fromUtf8("Gr0up P@ss w\xc3\xb6rd");
+}
+
+void CiscoPasswordTest::decryptTest()
+{
+    QFETCH(QString, encrypted);
+    QFETCH(QString, password);
+
+    QCOMPARE(CiscoPassword::decrypt(encrypted), password);
+}
+
+void CiscoPasswordTest::invalidTest_data()
+{
+    QTest::addColumn<QString>("encrypted");
+
+    QTest::newRow("empty") << QString();
+    QTest::newRow("too short") << "9196FE0075E359E6A2486905A1EFAE9A11D652B2C588EF3FBA15574237302B74";
+    QTest::newRow("odd length") << "9196FE0075E359E6A2486905A1EFAE9A11D652B2C588EF3FBA15574237302B74C194EC7D0DD16645CB534D94CE85FEC";
+    QTest::newRow("not hex") << "9196FE0075E359E6A2486905A1EFAE9A11D652B2C588EF3FBA15574237302B74C194EC7D0DD16645CB534D94CE85FEXX";
+    QTest::newRow("partial block") << "9196FE0075E359E6A2486905A1EFAE9A11D652B2C588EF3FBA15574237302B74C194EC7D0DD16645CB534D94CE85FEC400";
+    // Last byte of the ciphertext changed, its hash doesn't match anymore
+    QTest::newRow("corrupted") << "9196FE0075E359E6A2486905A1EFAE9A11D652B2C588EF3FBA15574237302B74C194EC7D0DD16645CB534D94CE85FEC5";
+}
+
+void CiscoPasswordTest::invalidTest()
+{
+    QFETCH(QString, encrypted);
+
+    QVERIFY(CiscoPassword::decrypt(encrypted).isNull());
+}
+
+void CiscoPasswordTest::decryptBenchmark()
+{
+    const QString encrypted = QStringLiteral("9196FE0075E359E6A2486905A1EFAE9A11D652B2C588EF3FBA15574237302B74C194EC7D0DD16645CB534D94CE85FEC4");
+
+    QBENCHMARK {
+        QCOMPARE(CiscoPassword::decrypt(encrypted), QStringLiteral("letmein"));
+    }
+}
+
+QTEST_GUILESS_MAIN(CiscoPasswordTest)
+
+#include "ciscopasswordtest.moc"
@@ -0,0 +1,106 @@
+/*
+Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "connectioneditortabwidget.h"
+
+#include <NetworkManagerQt/ConnectionSettings>
+
+#include <QTest>
+#include <QUuid>
+
+class ConnectionEditorBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void untouchedTabsTest();
+    void newConnectionBenchmark();
+    void existingConnectionBenchmark();
+
+private:
+    // Wi-Fi profile with 802.1x and static addressing, one of the heaviest ones to edit
+    static NetworkManager::ConnectionSettings::Ptr wifiConnection(const QString &id);
+};
+
+NetworkManager::ConnectionSettings::Ptr ConnectionEditorBenchmark::wifiConnection(const QString &id)
+{
+    NMVariantMapMap map;
+    map.insert(QStringLiteral("connection"), {
+        {QStringLiteral("id"), id},
+        {QStringLiteral("uuid"), QUuid::createUuid().toString().mid(1, 36)},
+        {QStringLiteral("type"), QStringLiteral("802-11-wireless")}
+    });
+    map.insert(QStringLiteral("802-11-wireless"), {
+        {QStringLiteral("ssid"), QByteArray("Office")},
+        {QStringLiteral("mode"), QStringLiteral("infrastructure")},
+        {QStringLiteral("security"), QStringLiteral("802-11-wireless-security")}
+    });
+    map.insert(QStringLiteral("802-11-wireless-security"), {
+        {QStringLiteral("key-mgmt"), QStringLiteral("wpa-eap")}
+    });
+    map.insert(QStringLiteral("802-1x"), {
+        {QStringLiteral("eap"), QStringList{QStringLiteral("peap")}},
+        {QStringLiteral("identity"), QStringLiteral("user")},
+        {QStringLiteral("phase2-auth"), QStringLiteral("mschapv2")}
+    });
+    map.insert(QStringLiteral("ipv4"), {
+        {QStringLiteral("method"), QStringLiteral("manual")},
+        {QStringLiteral("address-data"), QVariant::fromValue(QList<QVariantMap>{ {{QStringLiteral("address"), QStringLiteral("192.168.1.10")}, {QStringLiteral("prefix"), 24u}} })}
+    });
+
+    NetworkManager::ConnectionSettings::Ptr settings(new NetworkManager::ConnectionSettings(NetworkManager::ConnectionSettings::Wireless));
+    settings->fromMap(map);
+    return settings;
+}
+
+void ConnectionEditorBenchmark::untouchedTabsTest()
+{
+    NetworkManager::ConnectionSettings::Ptr connection = wifiConnection(QStringLiteral("Office"));
+    const NMVariantMapMap original = connection->toMap();
+
+    ConnectionEditorTabWidget editor(connection);
+    QVERIFY(editor.isValid());
+
+    // None of the tabs was shown, so the editor must hand back what the connection had
+    const NMVariantMapMap settings = editor.setting();
+    QCOMPARE(settings.value(QStringLiteral("802-11-wireless-security")), original.value(QStringLiteral("802-11-wireless-security")));
+    QCOMPARE(settings.value(QStringLiteral("802-1x")), original.value(QStringLiteral("802-1x")));
+    QCOMPARE(settings.value(QStringLiteral("ipv4")), original.value(QStringLiteral("ipv4")));
+    QCOMPARE(settings.value(QStringLiteral("connection")).value(QStringLiteral("id")).toString(), QStringLiteral("Office"));
+}
+
+void ConnectionEditorBenchmark::newConnectionBenchmark()
+{
+    // New connections still get all their tabs right away, this is what opening any connection used to cost
+    QBENCHMARK {
+        ConnectionEditorTabWidget editor(wifiConnection(QString()));
+    }
+}
+
+void ConnectionEditorBenchmark::existingConnectionBenchmark()
+{
+    QBENCHMARK {
+        ConnectionEditorTabWidget editor(wifiConnection(QStringLiteral("Office")));
+    }
+}
+
+QTEST_MAIN(ConnectionEditorBenchmark)
+
+#include "connectioneditorbenchmark.moc"
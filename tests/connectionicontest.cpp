@@ -0,0 +1,60 @@
+/*
+Copyright 2021  Wang Rui <wangrui@jingos.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "connectionicon.h"
+
+#include <QTest>
+
+class ConnectionIconTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void burstTest();
+};
+
+void ConnectionIconTest::burstTest()
+{
+    // Let whatever the constructor scheduled settle first
+    ConnectionIcon icon;
+    QTest::qWait(50);
+    const int before = icon.recomputeCount();
+
+    // A burst of changes like the ones NetworkManager sends while a connection comes up,
+    // the slots are private so call them the way the signals do
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY(QMetaObject::invokeMethod(&icon, "wirelessEnabledChanged", Q_ARG(bool, i % 2)));
+        QVERIFY(QMetaObject::invokeMethod(&icon, "wwanEnabledChanged", Q_ARG(bool, i % 2)));
+        QVERIFY(QMetaObject::invokeMethod(&icon, "carrierChanged", Q_ARG(bool, i % 2)));
+        QVERIFY(QMetaObject::invokeMethod(&icon, "activeConnectionDestroyed"));
+        QVERIFY(QMetaObject::invokeMethod(&icon, "primaryConnectionChanged", Q_ARG(QString, QStringLiteral("/org/freedesktop/NetworkManager/ActiveConnection/1"))));
+    }
+
+    // Nothing is recomputed before the event loop runs, then everything at once
+    QCOMPARE(icon.recomputeCount(), before);
+    QTRY_COMPARE(icon.recomputeCount(), before + 1);
+
+    QTest::qWait(50);
+    QCOMPARE(icon.recomputeCount(), before + 1);
+}
+
+QTEST_GUILESS_MAIN(ConnectionIconTest)
+
+#include "connectionicontest.moc"
@@ -0,0 +1,181 @@
+/*
+Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "connectioneditortabwidget.h"
+#include "firewallzones.h"
+
+#include <QDBusAbstractAdaptor>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTest>
+#include <QTimer>
+#include <QUuid>
+
+#define FAKE_FIREWALLD_SERVICE "org.kde.plasmanm.FakeFirewallD"
+#define FIREWALLD_SERVICE "org.fedoraproject.FirewallD1"
+#define FIREWALLD_PATH "/org/fedoraproject/FirewallD1"
+// Long enough to notice anybody waiting for the answer
+#define FAKE_FIREWALLD_DELAY 3000
+
+// Fake org.fedoraproject.FirewallD1.zone, answers getZones only after a delay
+class FakeFirewallZones : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.fedoraproject.FirewallD1.zone")
+public:
+    FakeFirewallZones(QObject *parent, const QDBusConnection &bus)
+        : QDBusAbstractAdaptor(parent)
+        , m_bus(bus)
+        , m_zones({QStringLiteral("public"), QStringLiteral("work")})
+    {
+    }
+
+    void setZones(const QStringList &zones)
+    {
+        m_zones = zones;
+        m_bus.send(QDBusMessage::createSignal(QStringLiteral(FIREWALLD_PATH), QStringLiteral("org.fedoraproject.FirewallD1"), QStringLiteral("Reloaded")));
+    }
+
+public Q_SLOTS:
+    QStringList getZones(const QDBusMessage &message)
+    {
+        message.setDelayedReply(true);
+        const QStringList zones = m_zones;
+        QDBusConnection bus = m_bus;
+        QTimer::singleShot(FAKE_FIREWALLD_DELAY, this, [bus, message, zones] () mutable {
+            bus.send(message.createReply(zones));
+        });
+        return QStringList();
+    }
+
+private:
+    QDBusConnection m_bus;
+    QStringList m_zones;
+};
+
+class FirewallZonesTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void zonesTest();
+    void reloadTest();
+    void missingServiceTest();
+    void editorTest();
+
+private:
+    QObject *m_root = nullptr;
+    FakeFirewallZones *m_fake = nullptr;
+    FirewallZones *m_zones = nullptr;
+};
+
+void FirewallZonesTest::initTestCase()
+{
+    // Let the shared instance, which talks to the system bus, find the fake as well
+    const QByteArray sessionBus = qgetenv("DBUS_SESSION_BUS_ADDRESS");
+    if (sessionBus.isEmpty()) {
+        QSKIP("No session bus to run the fake FirewallD on");
+    }
+    qputenv("DBUS_SYSTEM_BUS_ADDRESS", sessionBus);
+
+    // The fake lives on its own connection so that all traffic really goes through the bus
+    QDBusConnection bus = QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral("fakefirewalld"));
+    QVERIFY(bus.isConnected());
+
+    m_root = new QObject(this);
+    m_fake = new FakeFirewallZones(m_root, bus);
+    QVERIFY(bus.registerObject(QStringLiteral(FIREWALLD_PATH), m_root, QDBusConnection::ExportAdaptors));
+    QVERIFY(bus.registerService(QStringLiteral(FAKE_FIREWALLD_SERVICE)));
+}
+
+void FirewallZonesTest::cleanupTestCase()
+{
+    QDBusConnection::disconnectFromBus(QStringLiteral("fakefirewalld"));
+}
+
+void FirewallZonesTest::zonesTest()
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_zones = new FirewallZones(QDBusConnection::sessionBus(), QStringLiteral(FAKE_FIREWALLD_SERVICE), this);
+    QVERIFY(timer.elapsed() < FAKE_FIREWALLD_DELAY);
+    QVERIFY(!m_zones->isReady());
+    QVERIFY(m_zones->zones().isEmpty());
+
+    QSignalSpy spy(m_zones, &FirewallZones::zonesChanged);
+    QTRY_VERIFY_WITH_TIMEOUT(m_zones->isReady(), FAKE_FIREWALLD_DELAY * 2);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(m_zones->zones(), QStringList({QStringLiteral("public"), QStringLiteral("work")}));
+}
+
+void FirewallZonesTest::reloadTest()
+{
+    QSignalSpy spy(m_zones, &FirewallZones::zonesChanged);
+    m_fake->setZones({QStringLiteral("home"), QStringLiteral("public"), QStringLiteral("work")});
+
+    // The old zones stay available while FirewallD answers
+    QCOMPARE(m_zones->zones(), QStringList({QStringLiteral("public"), QStringLiteral("work")}));
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 1, FAKE_FIREWALLD_DELAY * 2);
+    QCOMPARE(m_zones->zones(), QStringList({QStringLiteral("home"), QStringLiteral("public"), QStringLiteral("work")}));
+}
+
+void FirewallZonesTest::missingServiceTest()
+{
+    FirewallZones zones(QDBusConnection::sessionBus(), QStringLiteral("org.kde.plasmanm.MissingFirewallD"));
+    QTRY_VERIFY(zones.isReady());
+    QVERIFY(zones.zones().isEmpty());
+}
+
+void FirewallZonesTest::editorTest()
+{
+    QDBusConnection bus(QStringLiteral("fakefirewalld"));
+    QVERIFY(bus.registerService(QStringLiteral(FIREWALLD_SERVICE)));
+
+    NMVariantMapMap map;
+    map.insert(QStringLiteral("connection"), {
+        {QStringLiteral("id"), QStringLiteral("Office")},
+        {QStringLiteral("uuid"), QUuid::createUuid().toString().mid(1, 36)},
+        {QStringLiteral("type"), QStringLiteral("802-3-ethernet")},
+        {QStringLiteral("zone"), QStringLiteral("work")}
+    });
+    NetworkManager::ConnectionSettings::Ptr connection(new NetworkManager::ConnectionSettings(NetworkManager::ConnectionSettings::Wired));
+    connection->fromMap(map);
+
+    QElapsedTimer timer;
+    timer.start();
+    ConnectionEditorTabWidget editor(connection);
+    QVERIFY(timer.elapsed() < FAKE_FIREWALLD_DELAY);
+
+    // The zone must survive both the wait for FirewallD and the zones arriving
+    QCOMPARE(editor.setting().value(QStringLiteral("connection")).value(QStringLiteral("zone")).toString(), QStringLiteral("work"));
+    QTRY_VERIFY_WITH_TIMEOUT(FirewallZones::self()->isReady(), FAKE_FIREWALLD_DELAY * 2);
+    QVERIFY(FirewallZones::self()->zones().contains(QStringLiteral("work")));
+    QCOMPARE(editor.setting().value(QStringLiteral("connection")).value(QStringLiteral("zone")).toString(), QStringLiteral("work"));
+
+    QVERIFY(bus.unregisterService(QStringLiteral(FIREWALLD_SERVICE)));
+}
+
+QTEST_MAIN(FirewallZonesTest)
+
+#include "firewallzonestest.moc"
@@ -0,0 +1,239 @@
+/*
+Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mobileproviders.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+// Roughly the size of the real database
+#define COUNTRY_COUNT 200
+#define PROVIDERS_PER_COUNTRY 10
+
+class MobileProvidersBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cacheTest();
+    void networkIdTest();
+    void countriesTest();
+    void missingFileTest();
+    void corruptedCacheTest();
+    void parseBenchmark();
+    void cachedBenchmark();
+    void networkIdBenchmark();
+
+private:
+    static QString countryCode(int country);
+    QTemporaryDir m_dir;
+    QString m_providersFile;
+};
+
+QString MobileProvidersBenchmark::countryCode(int country)
+{
+    return QString(QLatin1Char('A' + country / 26)) + QLatin1Char('A' + country % 26);
+}
+
+void MobileProvidersBenchmark::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QFile::remove(MobileProviders::cacheFilePath());
+
+    QVERIFY(m_dir.isValid());
+    m_providersFile = m_dir.filePath(QStringLiteral("serviceproviders.xml"));
+
+    QFile file(m_providersFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("<?xml version=\"1.0\"?>\n<serviceproviders format=\"2.0\">\n");
+    for (int c = 0; c < COUNTRY_COUNT; ++c) {
+        file.write(QStringLiteral("<country code=\"%1\">\n").arg(countryCode(c).toLower()).toUtf8());
+        for (int p = 0; p < PROVIDERS_PER_COUNTRY; ++p) {
+            file.write(QStringLiteral("<provider><name>Provider %1</name><name xml:lang=\"de-AT\">Anbieter %1</name><gsm>"
+                                      "<network-id mcc=\"%2\" mnc=\"%3\"/><network-id mcc=\"%2\" mnc=\"99\"/>"
+                                      "<apn value=\"internet%1\"><usage type=\"internet\"/><name>Internet</name>"
+                                      "<username>user</username><password>secret</password><dns>10.0.0.1</dns><dns>10.0.0.2</dns></apn>"
+                                      "<apn value=\"mms%1\"><usage type=\"mms\"/></apn>"
+                                      "</gsm></provider>\n").arg(p).arg(200 + c).arg(p, 2, 10, QLatin1Char('0')).toUtf8());
+        }
+        file.write("<provider><name>CDMA</name><cdma><username>cdma</username><sid value=\"1\">42</sid></cdma></provider>\n");
+        file.write("</country>\n");
+    }
+    file.write("</serviceproviders>\n");
+}
+
+void MobileProvidersBenchmark::cacheTest()
+{
+    // The first instance parses the XML and writes the cache
+    MobileProviders parsed(m_providersFile);
+    QCOMPARE(parsed.getError(), MobileProviders::Success);
+    QVERIFY(QFile::exists(MobileProviders::cacheFilePath()));
+
+    // The second one has to give the very same answers from the cache
+    MobileProviders cached(m_providersFile);
+    QCOMPARE(cached.getError(), MobileProviders::Success);
+
+    const QString country = countryCode(3);
+    const QStringList providers = parsed.getProvidersList(country, NetworkManager::ConnectionSettings::Gsm);
+    QCOMPARE(providers.size(), PROVIDERS_PER_COUNTRY);
+    QCOMPARE(cached.getProvidersList(country, NetworkManager::ConnectionSettings::Gsm), providers);
+
+    // Non internet APNs are left out
+    QCOMPARE(parsed.getApns(QStringLiteral("Provider 1")), QStringList{QStringLiteral("internet1")});
+    QCOMPARE(cached.getApns(QStringLiteral("Provider 1")), QStringList{QStringLiteral("internet1")});
+    QCOMPARE(cached.getNetworkIds(QStringLiteral("Provider 1")), QStringList({QStringLiteral("203-01"), QStringLiteral("203-99")}));
+
+    const QVariantMap apnInfo = parsed.getApnInfo(QStringLiteral("internet1"));
+    QCOMPARE(apnInfo.value(QStringLiteral("username")).toString(), QStringLiteral("user"));
+    QCOMPARE(apnInfo.value(QStringLiteral("dnsList")).toStringList(), QStringList({QStringLiteral("10.0.0.1"), QStringLiteral("10.0.0.2")}));
+    QCOMPARE(cached.getApnInfo(QStringLiteral("internet1")), apnInfo);
+
+    QCOMPARE(cached.getProvidersList(country, NetworkManager::ConnectionSettings::Cdma), QStringList{QStringLiteral("CDMA")});
+    const QVariantMap cdmaInfo = cached.getCdmaInfo(QStringLiteral("CDMA"));
+    QCOMPARE(cdmaInfo.value(QStringLiteral("username")).toString(), QStringLiteral("cdma"));
+    QVERIFY(!cdmaInfo.contains(QStringLiteral("password")));
+    QCOMPARE(cdmaInfo.value(QStringLiteral("sidList")).toStringList(), QStringList{QStringLiteral("42")});
+
+    QVERIFY(cached.getProvidersList(QStringLiteral("XX"), NetworkManager::ConnectionSettings::Gsm).isEmpty());
+}
+
+void MobileProvidersBenchmark::networkIdTest()
+{
+    MobileProviders providers(m_providersFile);
+
+    // Both the database and the modem notation of the network
+    QVariantMap apnInfo = providers.getApnInfoByNetworkId(QStringLiteral("203-01"));
+    QCOMPARE(apnInfo.value(QStringLiteral("apn")).toString(), QStringLiteral("internet1"));
+    QCOMPARE(apnInfo.value(QStringLiteral("provider")).toString(), QStringLiteral("Provider 1"));
+    QCOMPARE(apnInfo.value(QStringLiteral("country")).toString(), countryCode(3));
+    QCOMPARE(providers.getApnInfoByNetworkId(QStringLiteral("20301")), apnInfo);
+
+    // Shared networks are told apart by the name on the SIM
+    QCOMPARE(providers.getApnInfoByNetworkId(QStringLiteral("20399"), QStringLiteral("provider 4")).value(QStringLiteral("apn")).toString(),
+             QStringLiteral("internet4"));
+    QCOMPARE(providers.getApnInfoByNetworkId(QStringLiteral("20399"), QStringLiteral("Unknown")).value(QStringLiteral("apn")).toString(),
+             QStringLiteral("internet0"));
+
+    QVERIFY(providers.getApnInfoByNetworkId(QStringLiteral("99999")).isEmpty());
+}
+
+void MobileProvidersBenchmark::countriesTest()
+{
+    MobileProviders first(m_providersFile);
+    MobileProviders second(m_providersFile);
+
+    const QStringList countries = first.getCountryList();
+    QVERIFY(!countries.isEmpty());
+    QCOMPARE(second.getCountryList(), countries);
+    for (int i = 1; i < countries.size(); ++i) {
+        QVERIFY(countries.at(i - 1).localeAwareCompare(countries.at(i)) <= 0);
+    }
+
+    // Providers can be listed by the country name as well
+    const QString germany = first.getCountryName(QStringLiteral("DE"));
+    QVERIFY(countries.contains(germany));
+    QCOMPARE(first.getProvidersList(germany, NetworkManager::ConnectionSettings::Gsm),
+             first.getProvidersList(QStringLiteral("DE"), NetworkManager::ConnectionSettings::Gsm));
+}
+
+void MobileProvidersBenchmark::missingFileTest()
+{
+    MobileProviders providers(m_dir.filePath(QStringLiteral("missing.xml")));
+    QCOMPARE(providers.getError(), MobileProviders::ProvidersMissing);
+}
+
+void MobileProvidersBenchmark::corruptedCacheTest()
+{
+    {
+        MobileProviders providers(m_providersFile);
+    }
+
+    // Find the data of one country, the index is stored right after the header
+    // and the data of all countries is at the end of the file
+    QFile file(MobileProviders::cacheFilePath());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    quint32 magic, version;
+    QString providersFile;
+    qint64 modified, size;
+    QHash<QString, QPair<qint64, qint64>> index;
+    stream >> magic >> version >> providersFile >> modified >> size >> index;
+    QCOMPARE(stream.status(), QDataStream::Ok);
+
+    qint64 dataSize = 0;
+    for (const QPair<qint64, qint64> &entry : qAsConst(index)) {
+        dataSize = qMax(dataSize, entry.first + entry.second);
+    }
+    const QString country = countryCode(3);
+    QVERIFY(index.contains(country));
+
+    // Huge provider count which still passes all the checks of the header
+    QVERIFY(file.seek(file.size() - dataSize + index.value(country).first));
+    stream << qint32(0x7fffffff);
+    file.close();
+
+    // Treated like a missing cache, the providers file is parsed again and the cache rewritten
+    MobileProviders corrupted(m_providersFile);
+    QCOMPARE(corrupted.getProvidersList(country, NetworkManager::ConnectionSettings::Gsm).size(), PROVIDERS_PER_COUNTRY);
+
+    MobileProviders rewritten(m_providersFile);
+    QCOMPARE(rewritten.getProvidersList(country, NetworkManager::ConnectionSettings::Gsm).size(), PROVIDERS_PER_COUNTRY);
+}
+
+void MobileProvidersBenchmark::parseBenchmark()
+{
+    QBENCHMARK {
+        QFile::remove(MobileProviders::cacheFilePath());
+        MobileProviders providers(m_providersFile);
+        providers.getProvidersList(countryCode(3), NetworkManager::ConnectionSettings::Gsm);
+        providers.getApns(QStringLiteral("Provider 1"));
+    }
+}
+
+void MobileProvidersBenchmark::networkIdBenchmark()
+{
+    MobileProviders providers(m_providersFile);
+
+    QBENCHMARK {
+        providers.getApnInfoByNetworkId(QStringLiteral("32099"), QStringLiteral("Provider 9"));
+    }
+}
+
+void MobileProvidersBenchmark::cachedBenchmark()
+{
+    {
+        MobileProviders providers(m_providersFile);
+    }
+
+    QBENCHMARK {
+        MobileProviders providers(m_providersFile);
+        providers.getProvidersList(countryCode(3), NetworkManager::ConnectionSettings::Gsm);
+        providers.getApns(QStringLiteral("Provider 1"));
+    }
+}
+
+QTEST_GUILESS_MAIN(MobileProvidersBenchmark)
+
+#include "mobileprovidersbenchmark.moc"
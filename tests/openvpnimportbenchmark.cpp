@@ -0,0 +1,256 @@
+/*
+Copyright 2021  Wang Rui <wangrui@jingos.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "openvpn.h"
+
+#include <NetworkManagerQt/GenericTypes>
+#include <NetworkManagerQt/VpnSetting>
+
+#include <QDir>
+#include <QFile>
+#include <QHostAddress>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTextStream>
+
+#include <arpa/inet.h>
+
+// Size of the inline CA bundle in the benchmark, in certificates
+#define BUNDLE_CERTIFICATES 2000
+
+class OpenVpnImportBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void goldenTest_data();
+    void goldenTest();
+    void inlineBlocksTest();
+    void lineEndingsTest();
+    void connectionNameTest();
+    void parseBenchmark();
+
+private:
+    QString dump(const QString &fileName, const QString &dir);
+    static QByteArray referenceBlock(const QString &fileName, const QString &beginTag, const QString &endTag);
+    static QByteArray readFile(const QString &fileName);
+
+    QString m_corpusDir;
+    QString m_certsDir;
+    QTemporaryDir m_tempDir;
+    QString m_bigFile;
+};
+
+void OpenVpnImportBenchmark::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    m_certsDir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QLatin1String("/networkmanagement/certificates/");
+    QDir(m_certsDir).removeRecursively();
+
+    m_corpusDir = QDir(QFINDTESTDATA("data/openvpn")).absolutePath();
+    QVERIFY(QFile::exists(m_corpusDir + QLatin1String("/tls.ovpn")));
+
+    // A config with lots of options and a big inline CA bundle
+    QVERIFY(m_tempDir.isValid());
+    m_bigFile = m_tempDir.filePath(QStringLiteral("big.ovpn"));
+    QFile file(m_bigFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("client\ndev tun\nremote vpn.example.com 1194 udp\nauth-user-pass\n");
+    for (int i = 0; i < 500; ++i) {
+        file.write("# comment line with some words in it\nverb 3 ; comment\npersist-key\nresolv-retry infinite\n");
+    }
+    file.write("<ca>\n");
+    for (int i = 0; i < BUNDLE_CERTIFICATES; ++i) {
+        file.write("-----BEGIN CERTIFICATE-----\n");
+        for (int j = 0; j < 20; ++j) {
+            file.write("MIIDdzCCAl+gAwIBAgIEAgAAuTANBgkqhkiG9w0BAQUFADBaMQswCQYDVQQGEwJJ\n");
+        }
+        file.write("-----END CERTIFICATE-----\n");
+    }
+    file.write("</ca>\n");
+}
+
+QString OpenVpnImportBenchmark::dump(const QString &fileName, const QString &dir)
+{
+    OpenVpnUiPlugin plugin;
+    const NMVariantMapMap result = plugin.batchImportConnectionSettings(fileName, QVariantMap());
+
+    QStringList lines;
+    if (!result.isEmpty()) {
+        const QVariantMap connection = result.value(QStringLiteral("connection"));
+        lines << QStringLiteral("connection.id=") + connection.value(QStringLiteral("id")).toString();
+        lines << QStringLiteral("connection.type=") + connection.value(QStringLiteral("type")).toString();
+
+        NetworkManager::VpnSetting vpnSetting;
+        vpnSetting.fromMap(result.value(QStringLiteral("vpn")));
+        lines << QStringLiteral("vpn.service-type=") + vpnSetting.serviceType();
+        const NMStringMap data = vpnSetting.data();
+        for (auto it = data.constBegin(); it != data.constEnd(); ++it) {
+            lines << QStringLiteral("vpn.data.") + it.key() + QLatin1Char('=') + it.value();
+        }
+        const NMStringMap secrets = vpnSetting.secrets();
+        for (auto it = secrets.constBegin(); it != secrets.constEnd(); ++it) {
+            lines << QStringLiteral("vpn.secrets.") + it.key() + QLatin1Char('=') + it.value();
+        }
+
+        const UIntListList routes = result.value(QStringLiteral("ipv4")).value(QStringLiteral("routes")).value<UIntListList>();
+        for (const QList<uint> &route : routes) {
+            lines << QStringLiteral("ipv4.routes=") + QHostAddress(ntohl(route.value(0))).toString() + QLatin1Char('/') + QString::number(route.value(1));
+        }
+    }
+    for (const QString &warning : plugin.lastWarnings()) {
+        lines << QStringLiteral("warning=") + warning;
+    }
+    if (plugin.lastError() != VpnUiPlugin::NoError) {
+        lines << QStringLiteral("error=") + plugin.lastErrorMessage();
+    }
+
+    QString output = lines.join(QLatin1Char('\n')) + QLatin1Char('\n');
+    output.replace(m_certsDir, QLatin1String("@CERTS@"));
+    output.replace(dir, QLatin1String("@DIR@"));
+    return output;
+}
+
+QByteArray OpenVpnImportBenchmark::referenceBlock(const QString &fileName, const QString &beginTag, const QString &endTag)
+{
+    // Line by line, the way inline blocks used to be extracted
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        return QByteArray();
+    }
+
+    QTextStream in(&file);
+    QString block;
+    bool inside = false;
+    while (!in.atEnd()) {
+        const QString line = in.readLine();
+        if (!inside) {
+            inside = line.trimmed() == beginTag;
+        } else if (line.contains(endTag)) {
+            break;
+        } else {
+            block += line + QLatin1Char('\n');
+        }
+    }
+    return block.toUtf8();
+}
+
+QByteArray OpenVpnImportBenchmark::readFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+void OpenVpnImportBenchmark::goldenTest_data()
+{
+    QTest::addColumn<QString>("name");
+
+    for (const QString &fileName : QDir(m_corpusDir).entryList({QStringLiteral("*.ovpn")}, QDir::Files, QDir::Name)) {
+        const QString name = QFileInfo(fileName).completeBaseName();
+        QTest::newRow(qPrintable(name)) << name;
+    }
+}
+
+void OpenVpnImportBenchmark::goldenTest()
+{
+    QFETCH(QString, name);
+
+    const QString expected = QString::fromUtf8(readFile(m_corpusDir + QLatin1Char('/') + name + QLatin1String(".golden")));
+    QVERIFY(!expected.isEmpty());
+    QCOMPARE(dump(m_corpusDir + QLatin1Char('/') + name + QLatin1String(".ovpn"), m_corpusDir), expected);
+}
+
+void OpenVpnImportBenchmark::inlineBlocksTest()
+{
+    const QString fileName = m_corpusDir + QLatin1String("/inline.ovpn");
+    OpenVpnUiPlugin plugin;
+    plugin.batchImportConnectionSettings(fileName, QVariantMap());
+
+    const QStringList blocks { QStringLiteral("ca:ca.crt"), QStringLiteral("cert:cert.crt"), QStringLiteral("key:private.key"), QStringLiteral("tls-auth:tls_auth.key") };
+    for (const QString &block : blocks) {
+        const QString tag = block.section(QLatin1Char(':'), 0, 0);
+        const QString savedFile = m_certsDir + QLatin1String("inline/") + block.section(QLatin1Char(':'), 1);
+        const QByteArray reference = referenceBlock(fileName, QLatin1Char('<') + tag + QLatin1Char('>'), QLatin1String("</") + tag + QLatin1Char('>'));
+        QVERIFY(!reference.isEmpty());
+        QCOMPARE(readFile(savedFile), reference);
+    }
+
+    // Lines in the blocks are never parsed as options or comments
+    QVERIFY(readFile(m_certsDir + QLatin1String("inline/tls_auth.key")).startsWith("#\n# 2048 bit OpenVPN static key\n"));
+}
+
+void OpenVpnImportBenchmark::lineEndingsTest()
+{
+    // Files written on Windows give the same connection
+    const QString dir = m_tempDir.filePath(QStringLiteral("crlf"));
+    QVERIFY(QDir().mkpath(dir));
+    for (const QString &name : {QStringLiteral("inline"), QStringLiteral("tls")}) {
+        QByteArray content = readFile(m_corpusDir + QLatin1Char('/') + name + QLatin1String(".ovpn"));
+        content.replace("\n", "\r\n");
+
+        QFile file(dir + QLatin1Char('/') + name + QLatin1String(".ovpn"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(content);
+        file.close();
+
+        const QString expected = QString::fromUtf8(readFile(m_corpusDir + QLatin1Char('/') + name + QLatin1String(".golden")));
+        QCOMPARE(dump(file.fileName(), QDir(dir).absolutePath()), expected);
+    }
+
+    const QString fileName = m_corpusDir + QLatin1String("/inline.ovpn");
+    QCOMPARE(readFile(m_certsDir + QLatin1String("inline/ca.crt")), referenceBlock(fileName, QStringLiteral("<ca>"), QStringLiteral("</ca>")));
+}
+
+void OpenVpnImportBenchmark::connectionNameTest()
+{
+    // Files with the same name imported together must not share their inline certificates
+    const QString fileName = m_corpusDir + QLatin1String("/inline.ovpn");
+    OpenVpnUiPlugin plugin;
+    const NMVariantMapMap result = plugin.batchImportConnectionSettings(fileName, {{QStringLiteral("connectionName"), QStringLiteral("inline (2)")}});
+    QCOMPARE(result.value(QStringLiteral("connection")).value(QStringLiteral("id")).toString(), QStringLiteral("inline (2)"));
+
+    NetworkManager::VpnSetting vpnSetting;
+    vpnSetting.fromMap(result.value(QStringLiteral("vpn")));
+    QCOMPARE(vpnSetting.data().value(QStringLiteral("ca")), m_certsDir + QLatin1String("inline (2)/ca.crt"));
+    QCOMPARE(readFile(m_certsDir + QLatin1String("inline (2)/ca.crt")), referenceBlock(fileName, QStringLiteral("<ca>"), QStringLiteral("</ca>")));
+}
+
+void OpenVpnImportBenchmark::parseBenchmark()
+{
+    OpenVpnUiPlugin plugin;
+    const QByteArray reference = referenceBlock(m_bigFile, QStringLiteral("<ca>"), QStringLiteral("</ca>"));
+
+    QBENCHMARK {
+        const NMVariantMapMap result = plugin.batchImportConnectionSettings(m_bigFile, QVariantMap());
+        QVERIFY(!result.isEmpty());
+    }
+
+    QCOMPARE(plugin.lastWarnings(), QStringList());
+    QCOMPARE(readFile(m_certsDir + QLatin1String("big/ca.crt")), reference);
+}
+
+QTEST_GUILESS_MAIN(OpenVpnImportBenchmark)
+
+#include "openvpnimportbenchmark.moc"
@@ -0,0 +1,109 @@
+/*
+Copyright 2021  Wang Rui <wangrui@jingos.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Compare against the same catalog the labels come from
+#define TRANSLATION_DOMAIN "plasmanetworkmanagement-libs"
+
+#include "uiutils.h"
+
+#include <KLocalizedString>
+
+#include <QTest>
+
+class UiUtilsBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void labelsTest();
+    void languageChangeTest();
+    void uncachedLabelBenchmark();
+    void cachedLabelBenchmark();
+    void cachedSecurityLabelBenchmark();
+};
+
+void UiUtilsBenchmark::labelsTest()
+{
+    // Cached labels must be the same as the translated ones
+    QCOMPARE(UiUtils::connectionStateToString(NetworkManager::Device::Disconnected),
+             i18nc("description of unconnected network interface state", "Not connected"));
+    QCOMPARE(UiUtils::connectionStateToString(NetworkManager::Device::Disconnected),
+             i18nc("description of unconnected network interface state", "Not connected"));
+    QCOMPARE(UiUtils::connectionStateToString(NetworkManager::Device::Activated, QStringLiteral("Home")),
+             i18nc("network interface connected state label", "Connected to %1", QStringLiteral("Home")));
+    QCOMPARE(UiUtils::connectionStateToString(NetworkManager::Device::Activated),
+             i18nc("network interface connected state label", "Connected"));
+    QCOMPARE(UiUtils::vpnConnectionStateToString(NetworkManager::VpnConnection::Activated),
+             i18nc("The VPN connection is active", "Activated"));
+    QCOMPARE(UiUtils::labelFromWirelessSecurity(NetworkManager::Wpa2Psk),
+             i18nc("@label WPA2-PSK security", "WPA2-PSK"));
+    QCOMPARE(UiUtils::interfaceTypeLabel(NetworkManager::Device::Wifi, NetworkManager::Device::Ptr()),
+             i18nc("title of the interface widget in nm's popup", "Wi-Fi"));
+    QVERIFY(UiUtils::interfaceTypeLabel(NetworkManager::Device::Modem, NetworkManager::Device::Ptr()).isEmpty());
+}
+
+void UiUtilsBenchmark::languageChangeTest()
+{
+    const QString english = UiUtils::vpnConnectionStateToString(NetworkManager::VpnConnection::Failed);
+    QCOMPARE(english, i18nc("The VPN connection failed", "Failed"));
+
+    KLocalizedString::setLanguages({QStringLiteral("de")});
+    const QString german = i18nc("The VPN connection failed", "Failed");
+    const QString label = UiUtils::vpnConnectionStateToString(NetworkManager::VpnConnection::Failed);
+    KLocalizedString::clearLanguages();
+
+    if (german == english) {
+        QSKIP("German translations are not installed");
+    }
+    QCOMPARE(label, german);
+    QCOMPARE(UiUtils::vpnConnectionStateToString(NetworkManager::VpnConnection::Failed), english);
+}
+
+void UiUtilsBenchmark::uncachedLabelBenchmark()
+{
+    // What every call used to cost
+    QString label;
+    QBENCHMARK {
+        label = i18nc("description of unconnected network interface state", "Not connected");
+    }
+    QVERIFY(!label.isEmpty());
+}
+
+void UiUtilsBenchmark::cachedLabelBenchmark()
+{
+    QString label;
+    QBENCHMARK {
+        label = UiUtils::connectionStateToString(NetworkManager::Device::Disconnected);
+    }
+    QVERIFY(!label.isEmpty());
+}
+
+void UiUtilsBenchmark::cachedSecurityLabelBenchmark()
+{
+    QString label;
+    QBENCHMARK {
+        label = UiUtils::labelFromWirelessSecurity(NetworkManager::Wpa2Psk);
+    }
+    QVERIFY(!label.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(UiUtilsBenchmark)
+
+#include "uiutilsbenchmark.moc"
@@ -103,23 +103,29 @@ QString unQuote(QString &certVal, const QString &fileName)
     QString certFile = certVal.trimmed();
     if (certFile.startsWith('"') || certFile.startsWith('\'')) {  // Quoted
         certFile.remove(0,1);   // Remove the starting quote
-        nextSep = 0;
-        while ((nextSep = certFile.indexOf(QRegExp("\"|'"), nextSep)) != -1) {
-            if (nextSep > 0 && certFile.at(nextSep - 1) != '\\')  {  // Quote not escaped
+        for (nextSep = 0; nextSep < certFile.size(); ++nextSep) {
+            const QChar c = certFile.at(nextSep);
+            if ((c == QLatin1Char('"') || c == QLatin1Char('\'')) && (nextSep == 0 || certFile.at(nextSep - 1) != '\\')) {  // Quote not escaped
                 certVal = certFile.right(certFile.length() - nextSep - 1);  // Leftover string
                 certFile.truncate(nextSep);           // Quoted string
                 break;
             }
         }
     } else {
-        nextSep = certFile.indexOf(QRegExp("\\s"));   // First whitespace
-        if (nextSep != -1) {
+        nextSep = 0;
+        while (nextSep < certFile.size() && !certFile.at(nextSep).isSpace()) {
+            ++nextSep;
+        }
+        if (nextSep < certFile.size()) {    // First whitespace
             certVal = certFile.right(certFile.length() - nextSep - 1);  // Leftover
             certFile = certFile.left(nextSep);        // value
         } else {
             certVal.clear();
         }
     }
+    if (certFile.isEmpty()) {   // Empty quoted string, let the caller complain
+        return certFile;
+    }
     certFile.replace("\\\\", "\\");     // Replace '\\' with '\'
     certFile.replace("\\ ", " ");        // Replace escaped space with space
     if (QFileInfo(certFile).isRelative()) {
@@ -128,6 +134,65 @@ QString unQuote(QString &certVal, const QString &fileName)
     return certFile;
 }
 
+static inline bool isConfigSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/* Reads the line of @content starting at @pos and moves @pos to the beginning
+ * of the next one. The comment ('#' or ';' up to the end of the line) is dropped
+ * and the rest is split at whitespace into @tokens, @line is the line without
+ * the comment and @arguments the whole string after the first token.
+ * Returns false for lines without any token.
+ */
+static bool readConfigLine(const QByteArray &content, int &pos, QStringList &tokens, QString &line, QString &arguments)
+{
+    const char *data = content.constData();
+    int eol = content.indexOf('\n', pos);
+    if (eol < 0) {
+        eol = content.size();
+    }
+
+    int begin = pos;
+    int end = pos;
+    while (end < eol && data[end] != '#' && data[end] != ';') {
+        ++end;
+    }
+    pos = eol + 1;
+
+    while (begin < end && isConfigSpace(data[begin])) {
+        ++begin;
+    }
+    while (end > begin && isConfigSpace(data[end - 1])) {
+        --end;
+    }
+    if (begin == end) {
+        return false;
+    }
+
+    int keyEnd = -1;
+    int tokenBegin = begin;
+    while (tokenBegin < end) {
+        int tokenEnd = tokenBegin;
+        while (tokenEnd < end && !isConfigSpace(data[tokenEnd])) {
+            ++tokenEnd;
+        }
+        tokens << QString::fromUtf8(data + tokenBegin, tokenEnd - tokenBegin);
+        if (keyEnd < 0) {
+            keyEnd = tokenEnd;
+        }
+
+        tokenBegin = tokenEnd;
+        while (tokenBegin < end && isConfigSpace(data[tokenBegin])) {
+            ++tokenBegin;
+        }
+    }
+
+    line = QString::fromUtf8(data + begin, end - begin);
+    arguments = QString::fromUtf8(data + keyEnd, end - keyEnd);
+    return true;
+}
+
 bool isEncrypted(const QString &fileName)
 {
     bool encrypted = false;
@@ -182,25 +247,49 @@ QString OpenVpnUiPlugin::supportedFileExtensions() const
 
 NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileName)
 {
-    NMVariantMapMap result;
+    const NMVariantMapMap result = batchImportConnectionSettings(fileName, askImportOptions(nullptr));
 
-    QFile impFile(fileName);
-    if (!impFile.open(QFile::ReadOnly|QFile::Text)) {
-        mError = VpnUiPlugin::Error;
-        mErrorMessage = i18n("Could not open file");
-        return result;
+    for (const QString &warning : qAsConst(mWarnings)) {
+        KMessageBox::information(nullptr, warning);
     }
 
+    return result;
+}
+
+QVariantMap OpenVpnUiPlugin::askImportOptions(QWidget *parent)
+{
     bool copyCertificates;
     KMessageBox::ButtonCode buttonCode;
     if (KMessageBox::shouldBeShownYesNo(QLatin1String("copyCertificatesDialog"), buttonCode)) {
-        copyCertificates = KMessageBox::questionYesNo(nullptr, i18n("Do you want to copy your certificates to %1?", localCertPath()),
+        copyCertificates = KMessageBox::questionYesNo(parent, i18n("Do you want to copy your certificates to %1?", localCertPath()),
                                    i18n("Copy certificates"), KStandardGuiItem::yes(), KStandardGuiItem::no(), QLatin1String("copyCertificatesDialog")) == KMessageBox::Yes;
     } else {
         copyCertificates = buttonCode == KMessageBox::Yes;
     }
 
-    const QString connectionName = QFileInfo(fileName).completeBaseName();
+    return { {QLatin1String("copyCertificates"), copyCertificates} };
+}
+
+NMVariantMapMap OpenVpnUiPlugin::batchImportConnectionSettings(const QString &fileName, const QVariantMap &options)
+{
+    NMVariantMapMap result;
+
+    mError = VpnUiPlugin::NoError;
+    mWarnings.clear();
+
+    QFile impFile(fileName);
+    if (!impFile.open(QFile::ReadOnly|QFile::Text)) {
+        mError = VpnUiPlugin::Error;
+        mErrorMessage = i18n("Could not open file");
+        return result;
+    }
+
+    const bool copyCertificates = options.value(QLatin1String("copyCertificates")).toBool();
+
+    QString connectionName = options.value(QLatin1String("connectionName")).toString();
+    if (connectionName.isEmpty()) {
+        connectionName = QFileInfo(fileName).completeBaseName();
+    }
     NMStringMap dataMap;
     NMStringMap secretData;
     QVariantMap ipv4Data;
@@ -215,22 +304,20 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
     bool have_sk = false;
     int key_direction = -1;
 
-    QTextStream in(&impFile);
-    while (!in.atEnd()) {
+    // The file is tokenized in a single pass over its bytes, inline blocks are
+    // written out by saveFile() as they are, without splitting them into lines
+    const QByteArray content = impFile.readAll();
+    impFile.close();
+
+    int pos = 0;
+    while (pos < content.size()) {
         QStringList key_value;
-        QString line = in.readLine();
-        // Skip comments
-        if (line.indexOf('#') >= 0) {
-            line.truncate(line.indexOf('#'));
-        }
-        if (line.indexOf(';') >= 0) {
-            line.truncate(line.indexOf(';'));
-        }
-        if (line.isEmpty()) {
+        QString line;
+        QString arguments;
+        // Skip comments and empty lines
+        if (!readConfigLine(content, pos, key_value, line, arguments)) {
             continue;
         }
-        key_value.clear();
-        key_value << line.split(QRegExp("\\s+")); // Split at one or more whitespaces
 
         if (key_value[0] == CLIENT_TAG || key_value[0] == TLS_CLIENT_TAG) {
             have_client = true;
@@ -243,10 +330,10 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
                 } else if (key_value[1].startsWith(QLatin1String("tap"))) {
                     dataMap.insert(QLatin1String(NM_OPENVPN_KEY_TAP_DEV), "yes");
                 } else {
-                    KMessageBox::information(nullptr, i18n("Unknown option: %1", line));
+                    mWarnings << i18n("Unknown option: %1", line);
                 }
             } else {
-                KMessageBox::information(nullptr, i18n("Invalid number of arguments (expected 1) in option: %1", line));
+                mWarnings << i18n("Invalid number of arguments (expected 1) in option: %1", line);
             }
             continue;
         }
@@ -261,10 +348,10 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
                 } else if (key_value[1] == "tcp-client" || key_value[1] == "tcp-server" || key_value[1] == "tcp") {
                     dataMap.insert(QLatin1String(NM_OPENVPN_KEY_PROTO_TCP), "yes");
                 } else {
-                    KMessageBox::information(nullptr, i18n("Unknown option: %1", line));
+                    mWarnings << i18n("Unknown option: %1", line);
                 }
             } else {
-                KMessageBox::information(nullptr, i18n("Invalid number of arguments (expected 1) in option: %1", line));
+                mWarnings << i18n("Invalid number of arguments (expected 1) in option: %1", line);
             }
             continue;
         }
@@ -277,10 +364,10 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
                 if (key_value[1].toLong() >= 0 && key_value[1].toLong() < 0xFFFF ) {
                     dataMap.insert(QLatin1String(NM_OPENVPN_KEY_TUNNEL_MTU), key_value[1]);
                 } else {
-                    KMessageBox::information(nullptr, i18n("Invalid size (should be between 0 and 0xFFFF) in option: %1", line));
+                    mWarnings << i18n("Invalid size (should be between 0 and 0xFFFF) in option: %1", line);
                 }
             } else {
-                KMessageBox::information(nullptr, i18n("Invalid number of arguments (expected 1) in option: %1", line));
+                mWarnings << i18n("Invalid number of arguments (expected 1) in option: %1", line);
             }
             continue;
         }
@@ -289,10 +376,10 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
                 if (key_value[1].toLong() >= 0 && key_value[1].toLong() < 0xFFFF ) {
                     dataMap.insert(QLatin1String(NM_OPENVPN_KEY_FRAGMENT_SIZE), key_value[1]);
                 } else {
-                    KMessageBox::information(nullptr, i18n("Invalid size (should be between 0 and 0xFFFF) in option: %1", line));
+                    mWarnings << i18n("Invalid size (should be between 0 and 0xFFFF) in option: %1", line);
                 }
             } else {
-                KMessageBox::information(nullptr, i18n("Invalid number of arguments (expected 1) in option: %1", line));
+                mWarnings << i18n("Invalid number of arguments (expected 1) in option: %1", line);
             }
             continue;
         }
@@ -304,7 +391,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
             if (key_value.count() == 2) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_RENEG_SECONDS), key_value[1]);
             } else {
-                KMessageBox::information(nullptr, i18n("Invalid number of arguments (expected 1) in option: %1", line));
+                mWarnings << i18n("Invalid number of arguments (expected 1) in option: %1", line);
             }
             continue;
         }
@@ -358,7 +445,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
                 proxy_set = true;
             }
             if (!success) {
-                KMessageBox::information(nullptr, i18n("Invalid proxy option: %1", line));
+                mWarnings << i18n("Invalid proxy option: %1", line);
             }
             continue;
         }
@@ -393,70 +480,94 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
                     if (key_value[1].toLong() > 0 && key_value[1].toLong() < 65536) {
                         dataMap.insert(QLatin1String(NM_OPENVPN_KEY_PORT), key_value[1]);
                     } else {
-                        KMessageBox::information(nullptr, i18n("Invalid port (should be between 1 and 65535) in option: %1", line));
+                        mWarnings << i18n("Invalid port (should be between 1 and 65535) in option: %1", line);
                     }
                 } else
-                    KMessageBox::information(nullptr, i18n("Invalid number of arguments (expected 1) in option: %1", line));
+                    mWarnings << i18n("Invalid number of arguments (expected 1) in option: %1", line);
             }
             continue;
         }
         if (key_value[0] == PKCS12_TAG && key_value.count() > 1) {
-            key_value[1] = line.right(line.length() - line.indexOf(QRegExp("\\s"))); // Get whole string after key
+            key_value[1] = arguments; // Get whole string after key
             QString certFile = unQuote(key_value[1], fileName);
+            if (certFile.isEmpty()) {
+                mWarnings << i18n("Invalid argument in option: %1", line);
+                continue;
+            }
             dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CA), certFile);
             dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CERT), certFile);
             dataMap.insert(QLatin1String(NM_OPENVPN_KEY_KEY), certFile);
             continue;
         }
         if (key_value[0] == CA_TAG && key_value.count() > 1) {
-            key_value[1] = line.right(line.length() - line.indexOf(QRegExp("\\s"))); // Get whole string after key
+            key_value[1] = arguments; // Get whole string after key
             if (key_value[1].trimmed() == QLatin1String("[inline]")) {
                 // No data or file to copy for now, it will be available later when we reach <ca> tag.
                 continue;
             }
+            const QString certFile = unQuote(key_value[1], fileName);
+            if (certFile.isEmpty()) {
+                mWarnings << i18n("Invalid argument in option: %1", line);
+                continue;
+            }
             if (copyCertificates) {
-                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, unQuote(key_value[1], fileName));
+                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, certFile);
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CA), absoluteFilePath);
             } else {
-                dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CA), unQuote(key_value[1], fileName));
+                dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CA), certFile);
             }
             continue;
         }
         if (key_value[0] == CERT_TAG && key_value.count() > 1) {
-            key_value[1] = line.right(line.length() - line.indexOf(QRegExp("\\s"))); // Get whole string after key
+            key_value[1] = arguments; // Get whole string after key
             if (key_value[1].trimmed() == QLatin1String("[inline]")) {
                 // No data or file to copy for now, it will be available later when we reach <cert> tag.
                 continue;
             }
+            const QString certFile = unQuote(key_value[1], fileName);
+            if (certFile.isEmpty()) {
+                mWarnings << i18n("Invalid argument in option: %1", line);
+                continue;
+            }
             if (copyCertificates) {
-                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, unQuote(key_value[1], fileName));
+                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, certFile);
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CERT), absoluteFilePath);
             } else {
-                dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CERT), unQuote(key_value[1], fileName));
+                dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CERT), certFile);
             }
             continue;
         }
         if (key_value[0] == KEY_TAG && key_value.count() > 1) {
-            key_value[1] = line.right(line.length() - line.indexOf(QRegExp("\\s"))); // Get whole string after key
+            key_value[1] = arguments; // Get whole string after key
             if (key_value[1].trimmed() == QLatin1String("[inline]")) {
                 // No data or file to copy for now, it will be available later when we reach <key> tag.
                 continue;
             }
+            const QString certFile = unQuote(key_value[1], fileName);
+            if (certFile.isEmpty()) {
+                mWarnings << i18n("Invalid argument in option: %1", line);
+                continue;
+            }
             if (copyCertificates) {
-                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, unQuote(key_value[1], fileName));
+                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, certFile);
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_KEY), absoluteFilePath);
             } else {
-                dataMap.insert(QLatin1String(NM_OPENVPN_KEY_KEY), unQuote(key_value[1], fileName));
+                dataMap.insert(QLatin1String(NM_OPENVPN_KEY_KEY), certFile);
             }
             continue;
         }
         if (key_value[0] == SECRET_TAG && key_value.count() > 1) {
-            key_value[1] = line.right(line.length() - line.indexOf(QRegExp("\\s"))); // Get whole string after key
+            key_value[1] = arguments; // Get whole string after key
+            const QString certFile = unQuote(key_value[1], fileName);
+            if (certFile.isEmpty()) {
+                mWarnings << i18n("Invalid argument in option: %1", line);
+                continue;
+            }
             if (copyCertificates) {
-                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, unQuote(key_value[1], fileName));
+                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, certFile);
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_STATIC_KEY), absoluteFilePath);
             } else {
-                dataMap.insert(QLatin1String(NM_OPENVPN_KEY_STATIC_KEY), unQuote(key_value[1], fileName));
+                dataMap.insert(QLatin1String(NM_OPENVPN_KEY_STATIC_KEY), certFile);
             }
             if (key_value.count() > 2) {
                 key_value[2] = key_value[1];
@@ -468,15 +579,20 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
             continue;
         }
         if (key_value[0] == TLS_AUTH_TAG && key_value.count() >1) {
-            key_value[1] = line.right(line.length() - line.indexOf(QRegExp("\\s"))); // Get whole string after key
+            key_value[1] = arguments; // Get whole string after key
 
             // We will copy inline certificate later when we reach <tls-auth> tag.
             if (key_value[1].trimmed() != QLatin1String("[inline]")) {
+                const QString certFile = unQuote(key_value[1], fileName);
+                if (certFile.isEmpty()) {
+                    mWarnings << i18n("Invalid argument in option: %1", line);
+                    continue;
+                }
                 if (copyCertificates) {
-                    const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, unQuote(key_value[1], fileName));
+                    const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, certFile);
                     dataMap.insert(QLatin1String(NM_OPENVPN_KEY_TA), absoluteFilePath);
                 } else {
-                    dataMap.insert(QLatin1String(NM_OPENVPN_KEY_TA), unQuote(key_value[1], fileName));
+                    dataMap.insert(QLatin1String(NM_OPENVPN_KEY_TA), certFile);
                 }
             }
 
@@ -492,7 +608,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
             if (key_value.count() == 2) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CIPHER), key_value[1]);
             } else {
-                KMessageBox::information(nullptr, i18n("Invalid number of arguments (expected 1) in option: %1", line));
+                mWarnings << i18n("Invalid number of arguments (expected 1) in option: %1", line);
             }
             continue;
         }
@@ -500,7 +616,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
             if (!unQuote(key_value[1], fileName).isEmpty()) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_TLS_REMOTE), key_value[1]);
             } else {
-                KMessageBox::information(nullptr, i18n("Unknown option: %1", line));
+                mWarnings << i18n("Unknown option: %1", line);
             }
             continue;
         }
@@ -509,7 +625,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_LOCAL_IP), key_value[1]);
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_REMOTE_IP), key_value[2]);
             } else {
-                KMessageBox::information(nullptr, i18n("Invalid number of arguments (expected 2) in option: %1", line));
+                mWarnings << i18n("Invalid number of arguments (expected 2) in option: %1", line);
             }
             continue;
         }
@@ -520,7 +636,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
             if (key_value.count() == 2) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_AUTH), key_value[1]);
             } else {
-                KMessageBox::information(nullptr, i18n("Invalid number of arguments (expected 1) in option: %1", line));
+                mWarnings << i18n("Invalid number of arguments (expected 1) in option: %1", line);
             }
             continue;
         }
@@ -531,7 +647,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
             }
 
             if (key_direction != 0 && key_direction != 1) {
-                KMessageBox::information(nullptr, i18n("Invalid argument in option: %1", line));
+                mWarnings << i18n("Invalid argument in option: %1", line);
                 key_direction = -1;
             }
 
@@ -551,25 +667,25 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
         }
 
         if (key_value[0] == BEGIN_KEY_CA_TAG) {
-            const QString caAbsolutePath = saveFile(in, QLatin1String(END_KEY_CA_TAG), connectionName, "ca.crt");
+            const QString caAbsolutePath = saveFile(content, pos, END_KEY_CA_TAG, connectionName, "ca.crt");
             if (!caAbsolutePath.isEmpty()) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CA), caAbsolutePath);
             }
             continue;
         } else if (key_value[0] == BEGIN_KEY_CERT_TAG) {
-            const QString certAbsolutePath = saveFile(in, QLatin1String(END_KEY_CERT_TAG), connectionName, "cert.crt");
+            const QString certAbsolutePath = saveFile(content, pos, END_KEY_CERT_TAG, connectionName, "cert.crt");
             if (!certAbsolutePath.isEmpty()) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CERT), certAbsolutePath);
             }
             continue;
         } else if (key_value[0] == BEGIN_KEY_KEY_TAG) {
-            const QString keyAbsolutePath = saveFile(in, QLatin1String(END_KEY_KEY_TAG), connectionName, "private.key");
+            const QString keyAbsolutePath = saveFile(content, pos, END_KEY_KEY_TAG, connectionName, "private.key");
             if (!keyAbsolutePath.isEmpty()) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_KEY), keyAbsolutePath);
             }
             continue;
         } else if (key_value[0] == BEGIN_KEY_SECRET_TAG) {
-            const QString secretAbsolutePath = saveFile(in, QLatin1String(END_KEY_SECRET_TAG), connectionName, "secret.key");
+            const QString secretAbsolutePath = saveFile(content, pos, END_KEY_SECRET_TAG, connectionName, "secret.key");
             if (!secretAbsolutePath.isEmpty()) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_KEY), secretAbsolutePath);
                 have_sk = true;
@@ -580,7 +696,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
             }
             continue;
         } else if (key_value[0] == BEGIN_TLS_AUTH_TAG) {
-            const QString tlsAuthAbsolutePath = saveFile(in, QLatin1String(END_TLS_AUTH_TAG), connectionName, "tls_auth.key");
+            const QString tlsAuthAbsolutePath = saveFile(content, pos, END_TLS_AUTH_TAG, connectionName, "tls_auth.key");
             if (!tlsAuthAbsolutePath.isEmpty()) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_TA), tlsAuthAbsolutePath);
 
@@ -676,31 +792,46 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
         result.insert("ipv4", ipv4Data);
     }
 
-    impFile.close();
     return result;
 }
 
-QString OpenVpnUiPlugin::saveFile(QTextStream &in, const QString &endTag, const QString &connectionName, const QString &fileName)
+QString OpenVpnUiPlugin::saveFile(const QByteArray &content, int &pos, const char *endTag, const QString &connectionName, const QString &fileName)
 {
+    // The block goes up to the line with the end tag, that line itself is dropped
+    pos = qMin(pos, content.size());
+    const int blockBegin = pos;
+    int blockEnd = content.indexOf(endTag, blockBegin);
+    if (blockEnd < 0) {
+        blockEnd = content.size();
+        pos = content.size();
+    } else {
+        const int eol = content.indexOf('\n', blockEnd);
+        pos = eol < 0 ? content.size() : eol + 1;
+        blockEnd = content.lastIndexOf('\n', blockEnd) + 1;
+    }
+
+    QByteArray block = QByteArray::fromRawData(content.constData() + blockBegin, blockEnd - blockBegin);
+    if (block.contains('\r')) {
+        block.replace("\r\n", "\n");
+    }
+    if (!block.isEmpty() && !block.endsWith('\n')) {
+        block.append('\n');
+    }
+
     const QString certificatesDirectory = localCertPath() + connectionName;
     const QString absoluteFilePath = certificatesDirectory + '/' + fileName;
     QFile outFile(absoluteFilePath);
 
     QDir().mkpath(certificatesDirectory);
     if (!outFile.open(QFile::WriteOnly | QFile::Text)) {
-        KMessageBox::information(nullptr, i18n("Error saving file %1: %2", absoluteFilePath, outFile.errorString()));
+        mWarnings << i18n("Error saving file %1: %2", absoluteFilePath, outFile.errorString());
         return QString();
     }
 
-    QTextStream out(&outFile);
-    while (!in.atEnd()) {
-        const QString line = in.readLine();
-
-        if (line.indexOf(endTag) >= 0) {
-            break;
-        }
-
-        out << line << "\n";
+    // Inline CA bundles can be big, write the whole block at once
+    if (outFile.write(block) != block.size()) {
+        mWarnings << i18n("Error saving file %1: %2", absoluteFilePath, outFile.errorString());
+        return QString();
     }
 
     outFile.close();
@@ -716,7 +847,7 @@ QString OpenVpnUiPlugin::tryToCopyToCertificatesDirectory(const QString &connect
 
     QDir().mkpath(certificatesDirectory);
     if (!sourceFile.copy(absoluteFilePath)) {
-        KMessageBox::information(nullptr, i18n("Error copying certificate to %1: %2", absoluteFilePath, sourceFile.errorString()));
+        mWarnings << i18n("Error copying certificate to %1: %2", absoluteFilePath, sourceFile.errorString());
         return sourceFilePath;
     }
 
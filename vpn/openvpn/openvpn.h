@@ -41,10 +41,12 @@ public:
     QString suggestedFileName(const NetworkManager::ConnectionSettings::Ptr &connection) const override;
     QString supportedFileExtensions() const override;
     NMVariantMapMap importConnectionSettings(const QString &fileName) override;
+    QVariantMap askImportOptions(QWidget *parent) override;
+    NMVariantMapMap batchImportConnectionSettings(const QString &fileName, const QVariantMap &options) override;
     bool exportConnectionSettings(const NetworkManager::ConnectionSettings::Ptr &connection, const QString &fileName) override;
 
 private:
-    QString saveFile(QTextStream &in, const QString &endTag, const QString &connectionName, const QString &fileName);
+    QString saveFile(const QByteArray &content, int &pos, const char *endTag, const QString &connectionName, const QString &fileName);
     QString tryToCopyToCertificatesDirectory(const QString &connectionName, const QString &sourceFilePath);
 };
 
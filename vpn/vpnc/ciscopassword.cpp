@@ -0,0 +1,259 @@
+/*
+    Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of
+    the License or (at your option) version 3 or any later version
+    accepted by the membership of KDE e.V. (or its successor approved
+    by the membership of KDE e.V.), which shall act as a proxy
+    defined in Section 14 of version 3 of the license.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ciscopassword.h"
+
+#include <QCryptographicHash>
+
+#include <cctype>
+
+namespace
+{
+
+// DES tables from FIPS 46-3, bits are numbered from 1 starting with the most significant one
+
+const quint8 InitialPermutation[64] = {
+    58, 50, 42, 34, 26, 18, 10, 2, 60, 52, 44, 36, 28, 20, 12, 4,
+    62, 54, 46, 38, 30, 22, 14, 6, 64, 56, 48, 40, 32, 24, 16, 8,
+    57, 49, 41, 33, 25, 17, 9, 1, 59, 51, 43, 35, 27, 19, 11, 3,
+    61, 53, 45, 37, 29, 21, 13, 5, 63, 55, 47, 39, 31, 23, 15, 7
+};
+
+const quint8 FinalPermutation[64] = {
+    40, 8, 48, 16, 56, 24, 64, 32, 39, 7, 47, 15, 55, 23, 63, 31,
+    38, 6, 46, 14, 54, 22, 62, 30, 37, 5, 45, 13, 53, 21, 61, 29,
+    36, 4, 44, 12, 52, 20, 60, 28, 35, 3, 43, 11, 51, 19, 59, 27,
+    34, 2, 42, 10, 50, 18, 58, 26, 33, 1, 41, 9, 49, 17, 57, 25
+};
+
+const quint8 Expansion[48] = {
+    32, 1, 2, 3, 4, 5, 4, 5, 6, 7, 8, 9,
+    8, 9, 10, 11, 12, 13, 12, 13, 14, 15, 16, 17,
+    16, 17, 18, 19, 20, 21, 20, 21, 22, 23, 24, 25,
+    24, 25, 26, 27, 28, 29, 28, 29, 30, 31, 32, 1
+};
+
+const quint8 Permutation[32] = {
+    16, 7, 20, 21, 29, 12, 28, 17, 1, 15, 23, 26, 5, 18, 31, 10,
+    2, 8, 24, 14, 32, 27, 3, 9, 19, 13, 30, 6, 22, 11, 4, 25
+};
+
+const quint8 PermutedChoice1[56] = {
+    57, 49, 41, 33, 25, 17, 9, 1, 58, 50, 42, 34, 26, 18,
+    10, 2, 59, 51, 43, 35, 27, 19, 11, 3, 60, 52, 44, 36,
+    63, 55, 47, 39, 31, 23, 15, 7, 62, 54, 46, 38, 30, 22,
+    14, 6, 61, 53, 45, 37, 29, 21, 13, 5, 28, 20, 12, 4
+};
+
+const quint8 PermutedChoice2[48] = {
+    14, 17, 11, 24, 1, 5, 3, 28, 15, 6, 21, 10,
+    23, 19, 12, 4, 26, 8, 16, 7, 27, 20, 13, 2,
+    41, 52, 31, 37, 47, 55, 30, 40, 51, 45, 33, 48,
+    44, 49, 39, 56, 34, 53, 46, 42, 50, 36, 29, 32
+};
+
+const quint8 KeyShifts[16] = { 1, 1, 2, 2, 2, 2, 2, 2, 1, 2, 2, 2, 2, 2, 2, 1 };
+
+const quint8 SBoxes[8][64] = {
+    { 14, 4, 13, 1, 2, 15, 11, 8, 3, 10, 6, 12, 5, 9, 0, 7,
+      0, 15, 7, 4, 14, 2, 13, 1, 10, 6, 12, 11, 9, 5, 3, 8,
+      4, 1, 14, 8, 13, 6, 2, 11, 15, 12, 9, 7, 3, 10, 5, 0,
+      15, 12, 8, 2, 4, 9, 1, 7, 5, 11, 3, 14, 10, 0, 6, 13 },
+    { 15, 1, 8, 14, 6, 11, 3, 4, 9, 7, 2, 13, 12, 0, 5, 10,
+      3, 13, 4, 7, 15, 2, 8, 14, 12, 0, 1, 10, 6, 9, 11, 5,
+      0, 14, 7, 11, 10, 4, 13, 1, 5, 8, 12, 6, 9, 3, 2, 15,
+      13, 8, 10, 1, 3, 15, 4, 2, 11, 6, 7, 12, 0, 5, 14, 9 },
+    { 10, 0, 9, 14, 6, 3, 15, 5, 1, 13, 12, 7, 11, 4, 2, 8,
+      13, 7, 0, 9, 3, 4, 6, 10, 2, 8, 5, 14, 12, 11, 15, 1,
+      13, 6, 4, 9, 8, 15, 3, 0, 11, 1, 2, 12, 5, 10, 14, 7,
+      1, 10, 13, 0, 6, 9, 8, 7, 4, 15, 14, 3, 11, 5, 2, 12 },
+    { 7, 13, 14, 3, 0, 6, 9, 10, 1, 2, 8, 5, 11, 12, 4, 15,
+      13, 8, 11, 5, 6, 15, 0, 3, 4, 7, 2, 12, 1, 10, 14, 9,
+      10, 6, 9, 0, 12, 11, 7, 13, 15, 1, 3, 14, 5, 2, 8, 4,
+      3, 15, 0, 6, 10, 1, 13, 8, 9, 4, 5, 11, 12, 7, 2, 14 },
+    { 2, 12, 4, 1, 7, 10, 11, 6, 8, 5, 3, 15, 13, 0, 14, 9,
+      14, 11, 2, 12, 4, 7, 13, 1, 5, 0, 15, 10, 3, 9, 8, 6,
+      4, 2, 1, 11, 10, 13, 7, 8, 15, 9, 12, 5, 6, 3, 0, 14,
+      11, 8, 12, 7, 1, 14, 2, 13, 6, 15, 0, 9, 10, 4, 5, 3 },
+    { 12, 1, 10, 15, 9, 2, 6, 8, 0, 13, 3, 4, 14, 7, 5, 11,
+      10, 15, 4, 2, 7, 12, 9, 5, 6, 1, 13, 14, 0, 11, 3, 8,
+      9, 14, 15, 5, 2, 8, 12, 3, 7, 0, 4, 10, 1, 13, 11, 6,
+      4, 3, 2, 12, 9, 5, 15, 10, 11, 14, 1, 7, 6, 0, 8, 13 },
+    { 4, 11, 2, 14, 15, 0, 8, 13, 3, 12, 9, 7, 5, 10, 6, 1,
+      13, 0, 11, 7, 4, 9, 1, 10, 14, 3, 5, 12, 2, 15, 8, 6,
+      1, 4, 11, 13, 12, 3, 7, 14, 10, 15, 6, 8, 0, 5, 9, 2,
+      6, 11, 13, 8, 1, 4, 10, 7, 9, 5, 0, 15, 14, 2, 3, 12 },
+    { 13, 2, 8, 4, 6, 15, 11, 1, 10, 9, 3, 14, 5, 0, 12, 7,
+      1, 15, 13, 8, 10, 3, 7, 4, 12, 5, 6, 11, 0, 14, 9, 2,
+      7, 11, 4, 1, 9, 12, 14, 2, 0, 6, 10, 13, 15, 3, 5, 8,
+      2, 1, 14, 7, 4, 10, 8, 13, 15, 12, 9, 0, 3, 5, 6, 11 }
+};
+
+quint64 permute(quint64 in, int inBits, const quint8 *table, int outBits)
+{
+    quint64 out = 0;
+    for (int i = 0; i < outBits; ++i) {
+        out = (out << 1) | ((in >> (inBits - table[i])) & 1);
+    }
+    return out;
+}
+
+quint64 load64(const char *data)
+{
+    quint64 value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value = (value << 8) | quint8(data[i]);
+    }
+    return value;
+}
+
+void store64(quint64 value, char *data)
+{
+    for (int i = 7; i >= 0; --i) {
+        data[i] = char(value & 0xff);
+        value >>= 8;
+    }
+}
+
+class Des
+{
+public:
+    explicit Des(const char *key)
+    {
+        const quint64 cd = permute(load64(key), 64, PermutedChoice1, 56);
+        quint32 c = quint32(cd >> 28);
+        quint32 d = quint32(cd & 0xfffffff);
+        for (int i = 0; i < 16; ++i) {
+            c = ((c << KeyShifts[i]) | (c >> (28 - KeyShifts[i]))) & 0xfffffff;
+            d = ((d << KeyShifts[i]) | (d >> (28 - KeyShifts[i]))) & 0xfffffff;
+            m_subkeys[i] = permute((quint64(c) << 28) | d, 56, PermutedChoice2, 48);
+        }
+    }
+
+    quint64 encrypt(quint64 block) const
+    {
+        return crypt(block, false);
+    }
+
+    quint64 decrypt(quint64 block) const
+    {
+        return crypt(block, true);
+    }
+
+private:
+    static quint32 feistel(quint32 half, quint64 subkey)
+    {
+        const quint64 expanded = permute(half, 32, Expansion, 48) ^ subkey;
+        quint32 out = 0;
+        for (int i = 0; i < 8; ++i) {
+            const int bits = (expanded >> (42 - 6 * i)) & 0x3f;
+            const int row = ((bits >> 4) & 0x2) | (bits & 0x1);
+            const int column = (bits >> 1) & 0xf;
+            out = (out << 4) | SBoxes[i][row * 16 + column];
+        }
+        return quint32(permute(out, 32, Permutation, 32));
+    }
+
+    quint64 crypt(quint64 block, bool decrypt) const
+    {
+        block = permute(block, 64, InitialPermutation, 64);
+        quint32 left = quint32(block >> 32);
+        quint32 right = quint32(block);
+        for (int i = 0; i < 16; ++i) {
+            const quint32 next = left ^ feistel(right, m_subkeys[decrypt ? 15 - i : i]);
+            left = right;
+            right = next;
+        }
+        return permute((quint64(right) << 32) | left, 64, FinalPermutation, 64);
+    }
+
+    quint64 m_subkeys[16];
+};
+
+// 3DES (EDE with three keys) in CBC mode, @data has to be a multiple of the block size
+QByteArray tripleDesCbcDecrypt(const QByteArray &key, const QByteArray &iv, const QByteArray &data)
+{
+    const Des des1(key.constData());
+    const Des des2(key.constData() + 8);
+    const Des des3(key.constData() + 16);
+
+    QByteArray result(data.size(), Qt::Uninitialized);
+    quint64 previous = load64(iv.constData());
+    for (int i = 0; i < data.size(); i += 8) {
+        const quint64 block = load64(data.constData() + i);
+        store64(des1.decrypt(des2.encrypt(des3.decrypt(block))) ^ previous, result.data() + i);
+        previous = block;
+    }
+    return result;
+}
+
+} // namespace
+
+QString CiscoPassword::decrypt(const QString &encrypted)
+{
+    // Salt (20 bytes), SHA-1 of the ciphertext (20 bytes), ciphertext
+    const QByteArray hex = encrypted.trimmed().toLatin1();
+    if (hex.size() % 2) {
+        return QString();
+    }
+    for (const char c : hex) {
+        if (!isxdigit(static_cast<unsigned char>(c))) {
+            return QString();
+        }
+    }
+
+    const QByteArray data = QByteArray::fromHex(hex);
+    if (data.size() < 48 || (data.size() - 40) % 8) {
+        return QString();
+    }
+
+    const QByteArray salt = data.left(20);
+    const QByteArray hash = data.mid(20, 20);
+    const QByteArray cipherText = data.mid(40);
+
+    if (QCryptographicHash::hash(cipherText, QCryptographicHash::Sha1) != hash) {
+        return QString();
+    }
+
+    // The key is made of SHA-1 of the salt with the last byte incremented by one and then by three
+    QByteArray seed = salt;
+    seed[19] = char(seed.at(19) + 1);
+    QByteArray key = QCryptographicHash::hash(seed, QCryptographicHash::Sha1);
+    seed[19] = char(seed.at(19) + 2);
+    key += QCryptographicHash::hash(seed, QCryptographicHash::Sha1).left(4);
+
+    QByteArray plainText = tripleDesCbcDecrypt(key, salt.left(8), cipherText);
+
+    // Like cisco-decrypt, ignore malformed padding
+    const int padding = quint8(plainText.at(plainText.size() - 1));
+    if (padding <= 8) {
+        plainText.chop(padding);
+    }
+
+    // The password ends at the first NUL, if there is any
+    const int end = plainText.indexOf('\0');
+    if (end >= 0) {
+        plainText.truncate(end);
+    }
+
+    QString password = QString::fromUtf8(plainText);
+    plainText.fill('\0');
+    return password;
+}
@@ -0,0 +1,42 @@
+/*
+    Copyright 2021 Wang Rui <wangrui@jingos.com>
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of
+    the License or (at your option) version 3 or any later version
+    accepted by the membership of KDE e.V. (or its successor approved
+    by the membership of KDE e.V.), which shall act as a proxy
+    defined in Section 14 of version 3 of the license.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLASMA_NM_CISCO_PASSWORD_H
+#define PLASMA_NM_CISCO_PASSWORD_H
+
+#include <QString>
+
+/**
+ * Obfuscated passwords (enc_GroupPwd, enc_UserPassword) of Cisco VPN client profiles.
+ *
+ * The value is hex encoded: 20 bytes of salt, SHA-1 of the ciphertext and the password
+ * encrypted with 3DES-CBC, using a key derived from the salt. This is what cisco-decrypt
+ * from vpnc does, without having to run it for every password.
+ */
+class Q_DECL_EXPORT CiscoPassword
+{
+public:
+    /**
+     * Returns the password, or a null string when @encrypted is not a valid obfuscated password
+     */
+    static QString decrypt(const QString &encrypted);
+};
+
+#endif // PLASMA_NM_CISCO_PASSWORD_H
@@ -23,8 +23,8 @@
 
 #include "debug.h"
 #include "vpnc.h"
+#include "ciscopassword.h"
 
-#include <QStandardPaths>
 #include <QFile>
 #include <QFileInfo>
 
@@ -45,8 +45,6 @@
 
 VpncUiPluginPrivate::VpncUiPluginPrivate()
 {
-    decryptedPasswd.clear();
-    ciscoDecrypt = nullptr;
 }
 
 VpncUiPluginPrivate::~VpncUiPluginPrivate()
@@ -64,34 +62,6 @@ QString VpncUiPluginPrivate::readStringKeyValue(const KConfigGroup & configGroup
     }
 }
 
-void VpncUiPluginPrivate::gotCiscoDecryptOutput()
-{
-    QByteArray output = ciscoDecrypt->readAll();
-    if (!output.isEmpty()) {
-        QList<QByteArray> lines = output.split('\n');
-        if (!lines.isEmpty()) {
-            decryptedPasswd = QString::fromUtf8(lines.first());
-        }
-    }
-}
-
-void VpncUiPluginPrivate::ciscoDecryptFinished(int exitCode, QProcess::ExitStatus exitStatus)
-{
-    if (exitCode || exitStatus != QProcess::NormalExit) {
-        decryptedPasswd.clear();
-    }
-}
-
-void VpncUiPluginPrivate::ciscoDecryptError(QProcess::ProcessError pError)
-{
-    if (!pError) {
-        qCWarning(PLASMA_NM) << "Error in executing cisco-decrypt";
-        KMessageBox::error(nullptr, i18n("Error decrypting the obfuscated password"), i18n("Error"), KMessageBox::Notify);
-    }
-    decryptedPasswd.clear();
-}
-
-
 #define NM_VPNC_LOCAL_PORT_DEFAULT 500
 
 K_PLUGIN_CLASS_WITH_JSON(VpncUiPlugin, "plasmanetworkmanagement_vpncui.json")
@@ -129,11 +99,26 @@ QString VpncUiPlugin::supportedFileExtensions() const
 
 NMVariantMapMap VpncUiPlugin::importConnectionSettings(const QString &fileName)
 {
+    const NMVariantMapMap result = batchImportConnectionSettings(fileName, QVariantMap());
+
+    for (const QString &warning : qAsConst(mWarnings)) {
+        KMessageBox::error(nullptr, warning, i18n("Error"), KMessageBox::Notify);
+    }
+
+    return result;
+}
+
+NMVariantMapMap VpncUiPlugin::batchImportConnectionSettings(const QString &fileName, const QVariantMap &options)
+{
+    Q_UNUSED(options);
+
     // qCDebug(PLASMA_NM) << "Importing Cisco VPN connection from " << fileName;
 
     VpncUiPluginPrivate * decrPlugin = nullptr;
     NMVariantMapMap result;
 
+    mWarnings.clear();
+
     if (!fileName.endsWith(QLatin1String(".pcf"), Qt::CaseInsensitive)) {
         return result;
     }
@@ -150,20 +135,7 @@ NMVariantMapMap VpncUiPlugin::importConnectionSettings(const QString &fileName)
 
     KConfigGroup cg(config, "main");   // Keys&Values are stored under [main]
     if (cg.exists()) {
-        // Setup cisco-decrypt binary to decrypt the passwords
-        const QString ciscoDecryptBinary = QStandardPaths::findExecutable("cisco-decrypt");
-        if (ciscoDecryptBinary.isEmpty()) {
-            mErrorMessage = i18n("Needed executable cisco-decrypt could not be found.");
-            return result;
-        }
-
         decrPlugin = new VpncUiPluginPrivate();
-        decrPlugin->ciscoDecrypt = new KProcess(decrPlugin);
-        decrPlugin->ciscoDecrypt->setOutputChannelMode(KProcess::OnlyStdoutChannel);
-        decrPlugin->ciscoDecrypt->setReadChannel(QProcess::StandardOutput);
-        connect(decrPlugin->ciscoDecrypt, &KProcess::errorOccurred, decrPlugin, &VpncUiPluginPrivate::ciscoDecryptError);
-        connect(decrPlugin->ciscoDecrypt, QOverload<int, QProcess::ExitStatus>::of(&KProcess::finished), decrPlugin, &VpncUiPluginPrivate::ciscoDecryptFinished);
-        connect(decrPlugin->ciscoDecrypt, &KProcess::readyReadStandardOutput, decrPlugin, &VpncUiPluginPrivate::gotCiscoDecryptOutput);
 
         NMStringMap data;
         NMStringMap secretData;
@@ -176,14 +148,14 @@ NMVariantMapMap VpncUiPlugin::importConnectionSettings(const QString &fileName)
         // user password
         if (!decrPlugin->readStringKeyValue(cg,"UserPassword").isEmpty()) {
             secretData.insert(NM_VPNC_KEY_XAUTH_PASSWORD, decrPlugin->readStringKeyValue(cg,"UserPassword"));
-        } else if (!decrPlugin->readStringKeyValue(cg,"enc_UserPassword").isEmpty() && !ciscoDecryptBinary.isEmpty()) {
+        } else if (!decrPlugin->readStringKeyValue(cg,"enc_UserPassword").isEmpty()) {
             // Decrypt the password and insert into map
-            decrPlugin->ciscoDecrypt->setProgram(ciscoDecryptBinary);
-            decrPlugin->ciscoDecrypt->start();
-            decrPlugin->ciscoDecrypt->waitForStarted();
-            decrPlugin->ciscoDecrypt->write(decrPlugin->readStringKeyValue(cg,"enc_UserPassword").toUtf8());
-            if (decrPlugin->ciscoDecrypt->waitForFinished()) {
-                secretData.insert(NM_VPNC_KEY_XAUTH_PASSWORD, decrPlugin->decryptedPasswd);
+            const QString password = CiscoPassword::decrypt(decrPlugin->readStringKeyValue(cg,"enc_UserPassword"));
+            if (!password.isNull()) {
+                secretData.insert(NM_VPNC_KEY_XAUTH_PASSWORD, password);
+            } else {
+                qCWarning(PLASMA_NM) << "Error decrypting enc_UserPassword in" << fileName;
+                mWarnings << i18n("Error decrypting the obfuscated password");
             }
         }
         // Save user password
@@ -203,15 +175,15 @@ NMVariantMapMap VpncUiPlugin::importConnectionSettings(const QString &fileName)
         if (!decrPlugin->readStringKeyValue(cg,"GroupPwd").isEmpty()) {
             secretData.insert(NM_VPNC_KEY_SECRET, decrPlugin->readStringKeyValue(cg,"GroupPwd"));
             data.insert(NM_VPNC_KEY_SECRET"-flags", QString::number(NetworkManager::Setting::AgentOwned));
-        } else if (!decrPlugin->readStringKeyValue(cg,"enc_GroupPwd").isEmpty() && !ciscoDecryptBinary.isEmpty()) {
+        } else if (!decrPlugin->readStringKeyValue(cg,"enc_GroupPwd").isEmpty()) {
             //Decrypt the password and insert into map
-            decrPlugin->ciscoDecrypt->setProgram(ciscoDecryptBinary);
-            decrPlugin->ciscoDecrypt->start();
-            decrPlugin->ciscoDecrypt->waitForStarted();
-            decrPlugin->ciscoDecrypt->write(decrPlugin->readStringKeyValue(cg,"enc_GroupPwd").toUtf8());
-            if (decrPlugin->ciscoDecrypt->waitForFinished()) {
-                secretData.insert(NM_VPNC_KEY_SECRET, decrPlugin->decryptedPasswd);
+            const QString password = CiscoPassword::decrypt(decrPlugin->readStringKeyValue(cg,"enc_GroupPwd"));
+            if (!password.isNull()) {
+                secretData.insert(NM_VPNC_KEY_SECRET, password);
                 data.insert(NM_VPNC_KEY_SECRET"-flags", QString::number(NetworkManager::Setting::AgentOwned));
+            } else {
+                qCWarning(PLASMA_NM) << "Error decrypting enc_GroupPwd in" << fileName;
+                mWarnings << i18n("Error decrypting the obfuscated password");
             }
         }
 
@@ -265,7 +237,7 @@ NMVariantMapMap VpncUiPlugin::importConnectionSettings(const QString &fileName)
         data.insert(NM_VPNC_KEY_DHGROUP, decrPlugin->readStringKeyValue(cg,"DHGroup"));
         // Tunneling Mode - not supported by vpnc
         if (cg.readEntry("TunnelingMode").toInt() == 1) {
-            KMessageBox::error(nullptr, i18n("The VPN settings file '%1' specifies that VPN traffic should be tunneled through TCP which is currently not supported in the vpnc software.\n\nThe connection can still be created, with TCP tunneling disabled, however it may not work as expected.", fileName), i18n("Not supported"), KMessageBox::Notify);
+            mWarnings << i18n("The VPN settings file '%1' specifies that VPN traffic should be tunneled through TCP which is currently not supported in the vpnc software.\n\nThe connection can still be created, with TCP tunneling disabled, however it may not work as expected.", fileName);
         }
         // EnableLocalLAN and X-NM-Routes are to be added to IPv4Setting
         if (!cg.readEntry("EnableLocalLAN").isEmpty()) {
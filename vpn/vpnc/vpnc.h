@@ -28,7 +28,6 @@
 
 #include <QVariant>
 
-#include <KProcess>
 #include <KConfigGroup>
 
 class VpncUiPluginPrivate: public QObject
@@ -38,13 +37,6 @@ public:
     VpncUiPluginPrivate();
     ~VpncUiPluginPrivate() override;
     QString readStringKeyValue(const KConfigGroup & configGroup, const QString & key);
-    KProcess * ciscoDecrypt;
-    QString decryptedPasswd;
-
-public Q_SLOTS:
-    void gotCiscoDecryptOutput();
-    void ciscoDecryptError(QProcess::ProcessError pError);
-    void ciscoDecryptFinished(int exitCode, QProcess::ExitStatus exitStatus);
 };
 
 class Q_DECL_EXPORT VpncUiPlugin : public VpnUiPlugin
@@ -60,6 +52,7 @@ public:
     QString suggestedFileName(const NetworkManager::ConnectionSettings::Ptr &connection) const override;
     QString supportedFileExtensions() const override;
     NMVariantMapMap importConnectionSettings(const QString &fileName) override;
+    NMVariantMapMap batchImportConnectionSettings(const QString &fileName, const QVariantMap &options) override;
     bool exportConnectionSettings(const NetworkManager::ConnectionSettings::Ptr &connection, const QString &fileName) override;
 };
 